@@ -388,6 +388,59 @@ extern "C" {
  * 发送包：AA 09 00 00 00 00 00 00 00 00 00 00 B3 55  （查询状态）
  * 应答包：AA 09 50 46 50 46 50 46 00 00 00 00 45 55  （U/V/W相电流：18000mA，速度：0RPM，位置：0度）
  *
+ * @brief 状态订阅命令（CMD_STATUS_SUBSCRIBE = 0x12）
+ *
+ * 主机发送一次订阅，电机按周期主动上报指定数据ID的值，主机不再逐个读取。
+ * 订阅请求、订阅应答与主动上报都使用本命令字，不与状态查询共用：查询应答的字节2是U相电流低字节，
+ * 取任何值都可能，无法据此区分。本命令内字节2为子命令（1~3）时是订阅应答，为数据ID（>=0x10）时是主动上报。
+ *
+ * 订阅请求包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x12 │ 命令字：状态订阅                                                       │
+ * │ 2   │OP   │ 子命令：1=订阅（替换原订阅），2=追加数据ID，3=取消订阅                 │
+ * │3-4  │T    │ 2字节上报周期（小端格式，单位：0.1ms，uint16_t），追加/取消时忽略      │
+ * │ 5   │N    │ 本包携带的数据ID个数（0~6），取消订阅时为0                             │
+ * │6-11 │ID   │ 数据ID列表，不足6个补0；已订阅的数据ID忽略                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 订阅应答包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x12 │ 命令字：与发送包相同（0x12）                                           │
+ * │ 2   │OP   │ 子命令：与发送包相同                                                   │
+ * │ 3   │STATUS│ 1字节应答状态（ResponseStatus枚举值）                                │
+ * │ 4   │CNT  │ 当前已订阅的数据ID个数                                                 │
+ * │5-11 │0x00 │ 7字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 主动上报包格式（每个周期按订阅顺序上报全部数据ID，每包2个值）：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x12 │ 命令字：状态订阅                                                       │
+ * │ 2   │ID0  │ 第1个数据ID（>=0x10，据此与订阅应答区分）                              │
+ * │3-6  │DATA0│ 第1个数据值（小端格式，与读数据应答相同）                              │
+ * │ 7   │ID1  │ 第2个数据ID，为0表示本包只有1个值                                      │
+ * │8-11 │DATA1│ 第2个数据值（小端格式）                                                │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 示例：以10ms周期订阅转速当前值和Q轴电压当前值
+ * 发送包：AA 12 01 64 00 02 17 19 00 00 00 00 53 55  （订阅，周期100×0.1ms，2个数据ID）
+ * 应答包：AA 12 01 00 02 00 00 00 00 00 00 00 BF 55  （应答：RESPONSE_OK=0，已订阅2个）
+ * 上报包：AA 12 17 00 00 80 3F 19 00 00 00 00 AB 55  （转速1.0f，Q轴电压0.0f）
+ *
  * @brief 力矩控制命令（CMD_TORQUE_CONTROL = 0x0A）
  * 
  * 发送包格式：
@@ -570,6 +623,152 @@ extern "C" {
  * 应答包：AA 0D 10 27 D0 07 E0 0E 02 00 00 00 03 55  （电流：10000mA，速度：2000RPM，位置：360度，状态：MOTOR_STATE_WORKING）
  *
  *
+ * @brief 协议版本协商命令（CMD_PROTOCOL_NEGOTIATE = 0x10）
+ * 
+ * 协商成功后，电机到主机的批量数据（状态订阅的上报）改用v2变长帧，其余命令与应答仍为14字节v1帧。
+ * 主机请求版本1时恢复全部使用v1帧。不支持本命令的电机不应答，主机超时后继续使用v1。
+ * 
+ * 发送包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x10 │ 命令字：协议版本协商                                                   │
+ * │ 2   │VER  │ 请求的协议版本（1或2）                                                 │
+ * │3-4  │LEN  │ 主机可接收的最大载荷长度（小端格式，uint16_t）                          │
+ * │5-6  │T    │ 批量数据最长攒包时间（小端格式，单位：ms，uint16_t）                    │
+ * │7-11 │0x00 │ 5字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 应答包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x10 │ 命令字：与发送包相同（0x10）                                           │
+ * │ 2   │STATUS│ 1字节应答状态（ResponseStatus枚举值）                                │
+ * │ 3   │VER  │ 生效的协议版本                                                         │
+ * │4-5  │LEN  │ 电机实际使用的最大载荷长度（小端格式，uint16_t）                        │
+ * │6-11 │0x00 │ 6字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * v2变长帧格式（N为载荷长度，0~PROTOCOL_V2_MAX_PAYLOAD）：
+ * ┌───────┬─────┬───────────────────────────────────────────────────────────────────────┐
+ * │字节   │值   │                           说明                                        │
+ * ├───────┼─────┼───────────────────────────────────────────────────────────────────────┤
+ * │ 0     │0xA5 │ 包头固定值（与v1包头0xAA区分）                                        │
+ * │ 1     │CMD  │ 命令字（motor_command_t）                                             │
+ * │ 2     │SEQ  │ 序号，每发一帧加1，主机据此统计丢帧                                   │
+ * │3-4    │N    │ 载荷长度（小端格式，uint16_t）                                        │
+ * │ 5     │HCHK │ 帧头校验：字节0~4累加和取反的低8位                                    │
+ * │6~5+N  │DATA │ 载荷                                                                  │
+ * │6+N~7+N│CRC  │ CRC-16/CCITT-FALSE（多项式0x1021，初值0xFFFF），范围字节0~5+N，小端   │
+ * └───────┴─────┴───────────────────────────────────────────────────────────────────────┘
+ * 
+ * v2批量数据块（CMD_STATUS_SUBSCRIBE的v2帧载荷，协商v2后代替v1主动上报包）：
+ * ┌───────┬─────┬───────────────────────────────────────────────────────────────────────┐
+ * │字节   │值   │                           说明                                        │
+ * ├───────┼─────┼───────────────────────────────────────────────────────────────────────┤
+ * │ 0     │C    │ 通道数（订阅的数据ID个数）                                            │
+ * │1~C    │ID   │ 各通道数据ID（订阅顺序）                                              │
+ * │C+1~C+2│S    │ 样本数（小端格式，uint16_t）                                          │
+ * │C+3~C+4│T    │ 样本间隔（小端格式，单位：0.1ms，uint16_t）                            │
+ * │C+5~   │DATA │ S×C个4字节数据值（小端格式），按样本顺序排列，每个样本内按通道顺序      │
+ * └───────┴─────┴───────────────────────────────────────────────────────────────────────┘
+ * 
+ * 示例：协商v2，最大载荷512字节，最长攒包20ms
+ * 发送包：AA 10 02 00 02 14 00 00 00 00 00 00 D2 55
+ * 应答包：AA 10 00 02 00 02 00 00 00 00 00 00 BE 55  （应答：RESPONSE_OK=0，生效版本2，最大载荷512）
+ *
+ *
+ * @brief 突发捕获命令（CMD_BURST_CAPTURE = 0x11）
+ * 
+ * 电流环变量按PWM频率变化，轮询和订阅都跟不上。突发捕获由电机在电流环中把指定数据ID按分频
+ * 采样到片内RAM，触发后采满即停，主机再分块读回。字节2为burst_capture_op_t子命令：
+ * 配置通道与分频 -> 设置触发并启动 -> 查询状态直到采集完成 -> 分块读取（丢失的块重新读取）。
+ * 
+ * 配置请求包格式（BURST_CAPTURE_CONFIG，会中止正在进行的捕获）：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x11 │ 命令字：突发捕获                                                       │
+ * │ 2   │OP   │ 子命令：0=配置                                                         │
+ * │3-4  │DIV  │ 采样分频（小端格式，uint16_t，1表示每个电流环周期采样一次）            │
+ * │ 5   │N    │ 通道数（1~6）                                                          │
+ * │6-11 │ID   │ 各通道数据ID，不足6个补0                                               │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 配置应答包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x11 │ 命令字：与发送包相同（0x11）                                           │
+ * │ 2   │OP   │ 子命令：与发送包相同                                                   │
+ * │ 3   │STATUS│ 1字节应答状态（ResponseStatus枚举值）                                 │
+ * │4-7  │T    │ 采样间隔（小端格式，单位：ns，uint32_t，已含分频）                      │
+ * │8-9  │DEPTH│ 每通道可采样点数（小端格式，uint16_t，由片内缓冲区大小和通道数决定）    │
+ * │10-11│0x00 │ 2字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 启动请求包格式（BURST_CAPTURE_ARM）：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x11 │ 命令字：突发捕获                                                       │
+ * │ 2   │OP   │ 子命令：1=启动                                                         │
+ * │ 3   │MODE │ 触发方式（burst_trigger_mode_t）：0=立即，1=上升沿，2=下降沿            │
+ * │ 4   │CH   │ 触发通道序号（0~N-1）                                                  │
+ * │5-8  │LEVEL│ 触发电平（小端格式，float）                                            │
+ * │9-10 │PRE  │ 预触发点数（小端格式，uint16_t，不超过DEPTH）                           │
+ * │ 11  │0x00 │ 1字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 启动应答包：字节2为OP，字节3为应答状态，其余填充0。
+ * 
+ * 状态查询请求包（BURST_CAPTURE_STATUS）：字节2为OP=2，其余填充0。
+ * 状态应答包格式：
+ * ┌─────┬─────┬─────────────────────────────────────────────────────────────────────────┐
+ * │字节 │值   │                           说明                                        │
+ * ├─────┼─────┼─────────────────────────────────────────────────────────────────────────┤
+ * │ 0   │0xAA │ 包头固定值                                                             │
+ * │ 1   │0x11 │ 命令字：与发送包相同（0x11）                                           │
+ * │ 2   │OP   │ 子命令：与发送包相同                                                   │
+ * │ 3   │STATUS│ 1字节应答状态（ResponseStatus枚举值）                                 │
+ * │ 4   │STATE│ 捕获状态（burst_capture_state_t）                                      │
+ * │5-6  │S    │ 每通道已采样点数（小端格式，uint16_t）                                  │
+ * │7-8  │TRIG │ 触发点所在样本序号（小端格式，uint16_t，采集完成后有效）                │
+ * │9-10 │CNT  │ 按当前协议版本分块的总块数（小端格式，uint16_t，采集完成后有效）        │
+ * │ 11  │0x00 │ 1字节填充0                                                             │
+ * │ 12  │CHK  │ 校验和：从字节0到字节11的累加和                                       │
+ * │ 13  │0x55 │ 包尾固定值                                                             │
+ * └─────┴─────┴─────────────────────────────────────────────────────────────────────────┘
+ * 
+ * 分块读取请求包（BURST_CAPTURE_READ）：字节2为OP=3，字节3-4为起始块号，字节5-6为块数（均为小端uint16_t）。
+ * 电机依次发出每一块，不另外应答；超出总块数的块号忽略。捕获数据按样本顺序排列（最早的预触发样本在前），
+ * 每个样本内按通道顺序为4字节数据值（小端格式，与读数据命令相同）。第i块为数据的第i×B字节起的B字节，
+ * 最后一块可能不足B字节。v1帧每块B=BURST_CAPTURE_V1_CHUNK_BYTES，v2帧每块B=BURST_CAPTURE_V2_CHUNK_BYTES：
+ * - v1数据块包：字节2为OP=3，字节3-4为块号，字节5为本块有效字节数，字节6-11为数据
+ * - v2数据块帧（CMD_BURST_CAPTURE）：载荷字节0为OP=3，字节1-2为块号，其后为本块数据
+ * 
+ * 中止请求包（BURST_CAPTURE_ABORT）：字节2为OP=4，其余填充0；应答包字节2为OP，字节3为应答状态。
+ * 
+ * 示例：每2个电流环周期采样一次U/V相电流
+ * 发送包：AA 11 00 02 00 02 11 13 00 00 00 00 E3 55  （配置，分频2，2个通道）
+ * 应答包：AA 11 00 00 A0 86 01 00 00 08 00 00 EA 55  （应答：RESPONSE_OK=0，采样间隔100000ns，每通道2048点）
+ *
+ *
  * 应答规则：
  * 1. 所有应答包的命令字与发送包相同
  * 2. 数据采用小端格式（低位在前）
@@ -581,6 +780,12 @@ extern "C" {
 #define PROTOCOL_FOOTER 0x55    // 包尾
 #define PROTOCOL_LENGTH 14      // 固定包长
 
+// v2变长帧定义（协商后用于批量数据）
+#define PROTOCOL_V2_HEADER 0xA5          // 包头
+#define PROTOCOL_V2_HEADER_LENGTH 6      // 帧头长度（包头、命令字、序号、长度、帧头校验）
+#define PROTOCOL_V2_CRC_LENGTH 2         // CRC-16长度
+#define PROTOCOL_V2_MAX_PAYLOAD 512      // 最大载荷长度
+
 // 命令类型枚举
 typedef enum {
     CMD_WRITE_DATA = 0x01,       // 写数据
@@ -597,7 +802,10 @@ typedef enum {
     CMD_POSITION_CONTROL,       // 位置控制
     CMD_MOTION_CONTROL,         // 运控控制
     CMD_ZERO_SET_CURRENT,        // 设置当前角度为机械0位
-    CMD_MOTOR_CALIBRATE        // 电机校准
+    CMD_MOTOR_CALIBRATE,       // 电机校准
+    CMD_PROTOCOL_NEGOTIATE,    // 协议版本协商
+    CMD_BURST_CAPTURE,         // 突发捕获
+    CMD_STATUS_SUBSCRIBE       // 状态订阅与主动上报
 } motor_command_t;
 
 // 数据ID枚举（可读写的数据标识）
@@ -658,9 +866,51 @@ typedef enum {
     RESPONSE_INTERFACE_SET_FAILED,  // 接口设置失败
     RESPONSE_MOTOR_START_FAILED,    // 启动电机失败
     RESPONSE_MOTOR_STOP_FAILED,     // 停止电机失败
-    RESPONSE_ZERO_SET_FAILED        // 0位设置失败
+    RESPONSE_ZERO_SET_FAILED,       // 0位设置失败
+    RESPONSE_SUBSCRIBE_FAILED,      // 状态订阅失败（数据ID无效或超出订阅上限）
+    RESPONSE_PROTOCOL_UNSUPPORTED,  // 不支持请求的协议版本
+    RESPONSE_BURST_CAPTURE_FAILED   // 突发捕获失败（通道或参数无效、尚未配置）
 } ResponseStatus;
 
+// 状态订阅子命令（CMD_STATUS_SUBSCRIBE发送包字节2）；QUERY为CMD_STATUS_REPORT查询包的字节2
+typedef enum {
+    STATUS_REPORT_QUERY = 0,        // 查询一次状态
+    STATUS_REPORT_SUBSCRIBE,        // 订阅：按周期主动上报指定数据ID（替换原订阅）
+    STATUS_REPORT_SUBSCRIBE_APPEND, // 追加订阅的数据ID，周期不变
+    STATUS_REPORT_UNSUBSCRIBE       // 取消订阅，停止主动上报
+} status_report_op_t;
+
+#define STATUS_REPORT_IDS_PER_REQUEST 6 // 一个订阅请求包最多携带的数据ID个数
+#define STATUS_REPORT_MAX_IDS 32        // 订阅数据ID总数上限
+
+// 突发捕获子命令（CMD_BURST_CAPTURE发送包字节2）
+typedef enum {
+    BURST_CAPTURE_CONFIG = 0,       // 配置通道与采样分频
+    BURST_CAPTURE_ARM,              // 设置触发条件并启动
+    BURST_CAPTURE_STATUS,           // 查询捕获状态
+    BURST_CAPTURE_READ,             // 分块读取捕获数据
+    BURST_CAPTURE_ABORT             // 中止捕获
+} burst_capture_op_t;
+
+// 突发捕获触发方式
+typedef enum {
+    BURST_TRIGGER_IMMEDIATE = 0,    // 启动后立即触发
+    BURST_TRIGGER_RISING,           // 触发通道上升穿越触发电平
+    BURST_TRIGGER_FALLING           // 触发通道下降穿越触发电平
+} burst_trigger_mode_t;
+
+// 突发捕获状态
+typedef enum {
+    BURST_STATE_IDLE = 0,           // 未配置或已中止
+    BURST_STATE_ARMED,              // 已启动，等待触发
+    BURST_STATE_TRIGGERED,          // 已触发，正在采集触发后的样本
+    BURST_STATE_DONE                // 采集完成，可读取
+} burst_capture_state_t;
+
+#define BURST_CAPTURE_MAX_CHANNELS 6    // 通道数上限
+#define BURST_CAPTURE_V1_CHUNK_BYTES 6  // v1帧每块数据字节数
+#define BURST_CAPTURE_V2_CHUNK_BYTES 256 // v2帧每块数据字节数
+
 // 电机工作状态枚举
 typedef enum {
     MOTOR_STATE_IDLE = 0,     // 未工作状态
@@ -124,6 +124,13 @@ ApplicationWindow {
                             console.log("采集状态切换:", chartModule.isCollecting)
                         }
                     }
+
+                    // 突发捕获模块 - 电流环变量的高速波形
+                    BurstCaptureModule {
+                        id: burstCaptureModule
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: parent.height * 0.4
+                    }
                 }
             }
 
@@ -230,6 +237,11 @@ ApplicationWindow {
             }
         })
         
+        // 突发捕获过程写入日志
+        BurstCaptureManager.logMessage.connect(function(message) {
+            logModule.addLogMessage(message)
+        })
+        
         console.log("主界面初始化完成，信号连接已建立")
     }
 }
@@ -0,0 +1,51 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local int t_scopeDepth = 0;
+std::atomic<int64_t> g_allocations(0);
+
+void *countedAlloc(std::size_t size)
+{
+    if (t_scopeDepth > 0) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+} // namespace
+
+namespace AllocCounter {
+
+Scope::Scope() { ++t_scopeDepth; }
+Scope::~Scope() { --t_scopeDepth; }
+
+Pause::Pause() : m_savedDepth(t_scopeDepth) { t_scopeDepth = 0; }
+Pause::~Pause() { t_scopeDepth = m_savedDepth; }
+
+int64_t total() { return g_allocations.load(std::memory_order_relaxed); }
+
+} // namespace AllocCounter
+
+// 全局operator new/delete替换（对齐版本保持默认实现，与默认delete配对）
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t&) noexcept { std::free(p); }
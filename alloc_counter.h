@@ -0,0 +1,72 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief 堆分配计数 - 验证发送热路径稳态下不分配内存
+ *
+ * 替换全局operator new，在AllocCounter::Scope作用域内发生的分配计入total()；
+ * 作用域外只多一次线程局部变量判断。Pause用于排除作用域内不归本程序管的调用
+ * （如QSerialPort写缓冲、跨线程投递事件）。
+ *
+ * 诊断用，默认不编译：CMake选项FOC_COUNT_ALLOCATIONS打开时才编译alloc_counter.cpp（替换operator new）
+ * 并定义同名宏；未打开时Scope/Pause为空操作，total()返回-1表示不可用。
+ */
+namespace AllocCounter {
+
+#ifdef FOC_COUNT_ALLOCATIONS
+
+// 进入作用域后，当前线程的堆分配被计数（可嵌套）
+class Scope
+{
+public:
+    Scope();
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+// 在计数作用域内临时暂停计数
+class Pause
+{
+public:
+    Pause();
+    ~Pause();
+    Pause(const Pause&) = delete;
+    Pause& operator=(const Pause&) = delete;
+
+private:
+    int m_savedDepth;
+};
+
+// 累计计数（任意线程可读）
+int64_t total();
+
+#else
+
+class Scope
+{
+public:
+    Scope() {}
+    ~Scope() {}
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+class Pause
+{
+public:
+    Pause() {}
+    ~Pause() {}
+    Pause(const Pause&) = delete;
+    Pause& operator=(const Pause&) = delete;
+};
+
+inline int64_t total() { return -1; }
+
+#endif // FOC_COUNT_ALLOCATIONS
+
+} // namespace AllocCounter
+
+#endif // ALLOC_COUNTER_H
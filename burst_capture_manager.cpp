@@ -0,0 +1,413 @@
+#include "burst_capture_manager.h"
+#include "serial_communication_manager.h"
+#include <QXYSeries>
+#include <QPointF>
+#include <QDebug>
+#include <cstring>
+
+// 可捕获的电流环变量及其数据ID
+static const struct {
+    const char *name;
+    uint8_t dataId;
+} BURST_CHANNELS[] = {
+    {"U相电流", DATA_ID_PHASE_CURRENT_U_CURRENT},
+    {"V相电流", DATA_ID_PHASE_CURRENT_V_CURRENT},
+    {"W相电流", DATA_ID_PHASE_CURRENT_W_CURRENT},
+    {"电角度", DATA_ID_ELECTRICAL_ANGLE_CURRENT},
+    {"Q轴电压", DATA_ID_Q_VOLTAGE_CURRENT},
+    {"D轴电压", DATA_ID_D_VOLTAGE_CURRENT}
+};
+
+static const int BURST_POLL_INTERVAL_MS = 100;    // 等待触发/采集完成时的状态查询间隔
+static const int BURST_CHUNK_TIMEOUT_MS = 1000;   // 数据块（及配置应答）到达超时
+static const int BURST_MAX_STALLS = 5;            // 连续超时次数上限
+static const int BURST_V1_WINDOW_CHUNKS = 64;     // v1每次读取的块数（384字节）
+static const int BURST_V2_WINDOW_CHUNKS = 16;     // v2每次读取的块数（4KB）
+
+BurstCaptureManager* BurstCaptureManager::m_instance = nullptr;
+
+BurstCaptureManager* BurstCaptureManager::getInstance()
+{
+    if (!m_instance) {
+        m_instance = new BurstCaptureManager();
+    }
+    return m_instance;
+}
+
+BurstCaptureManager::BurstCaptureManager(QObject *parent)
+    : QObject(parent)
+    , m_state(Idle)
+    , m_triggerMode(BURST_TRIGGER_IMMEDIATE)
+    , m_triggerChannel(0)
+    , m_triggerLevel(0.0f)
+    , m_preTriggerPercent(0)
+    , m_samplePeriodNs(0)
+    , m_depth(0)
+    , m_sampleCount(0)
+    , m_triggerIndex(0)
+    , m_chunkBytes(BURST_CAPTURE_V1_CHUNK_BYTES)
+    , m_windowChunks(BURST_V1_WINDOW_CHUNKS)
+    , m_totalChunks(0)
+    , m_receivedChunks(0)
+    , m_retransmittedChunks(0)
+    , m_nextChunk(0)
+    , m_windowEnd(0)
+    , m_stalls(0)
+    , m_pollTimer(new QTimer(this))
+    , m_chunkTimer(new QTimer(this))
+{
+    // 与曲线一样按批接收协议帧
+    auto* serialManager = SerialCommunicationManager::getInstance();
+    connect(serialManager, &SerialCommunicationManager::framesReceived,
+            this, &BurstCaptureManager::onFramesReceived);
+    connect(serialManager, &SerialCommunicationManager::blocksReceived,
+            this, &BurstCaptureManager::onBlocksReceived);
+
+    m_pollTimer->setInterval(BURST_POLL_INTERVAL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &BurstCaptureManager::onPollTimeout);
+
+    m_chunkTimer->setSingleShot(true);
+    m_chunkTimer->setInterval(BURST_CHUNK_TIMEOUT_MS);
+    connect(m_chunkTimer, &QTimer::timeout, this, &BurstCaptureManager::onChunkTimeout);
+}
+
+QStringList BurstCaptureManager::availableChannels() const
+{
+    QStringList names;
+    for (const auto &channel : BURST_CHANNELS) {
+        names.append(QString::fromUtf8(channel.name));
+    }
+    return names;
+}
+
+QString BurstCaptureManager::stateText() const
+{
+    switch (m_state) {
+        case Idle: return "未开始";
+        case Configuring: return "配置中";
+        case Armed: return "等待触发";
+        case Triggered: return "采集中";
+        case Uploading: return "读取中";
+        case Done: return "完成";
+        case Failed: return "失败";
+    }
+    return QString();
+}
+
+bool BurstCaptureManager::startCapture(const QStringList &channels, int divider, int triggerMode,
+                                       int triggerChannel, double triggerLevel, int preTriggerPercent)
+{
+    auto* serialManager = SerialCommunicationManager::getInstance();
+    if (!serialManager->isConnected()) {
+        emit logMessage("突发捕获：串口未连接");
+        return false;
+    }
+    if (m_state >= Configuring && m_state <= Uploading) {
+        emit logMessage("突发捕获：上一次捕获尚未结束");
+        return false;
+    }
+    if (channels.isEmpty() || channels.size() > BURST_CAPTURE_MAX_CHANNELS
+        || triggerChannel < 0 || triggerChannel >= channels.size()
+        || triggerMode < BURST_TRIGGER_IMMEDIATE || triggerMode > BURST_TRIGGER_FALLING) {
+        emit logMessage("突发捕获：通道或触发设置无效");
+        return false;
+    }
+
+    QVector<uint8_t> ids;
+    for (const QString &name : channels) {
+        uint8_t id = 0;
+        for (const auto &channel : BURST_CHANNELS) {
+            if (name == QString::fromUtf8(channel.name)) {
+                id = channel.dataId;
+            }
+        }
+        if (id == 0) {
+            emit logMessage(QString("突发捕获：变量 '%1' 不支持捕获").arg(name));
+            return false;
+        }
+        ids.append(id);
+    }
+
+    m_channelNames = channels;
+    m_channelIds = ids;
+    m_triggerMode = uint8_t(triggerMode);
+    m_triggerChannel = uint8_t(triggerChannel);
+    m_triggerLevel = float(triggerLevel);
+    m_preTriggerPercent = qBound(0, preTriggerPercent, 100);
+    m_totalChunks = 0;
+    m_receivedChunks = 0;
+    m_retransmittedChunks = 0;
+    emit progressChanged();
+
+    // 分块读取尽量使用v2帧；不支持时按v1每块6字节读取
+    if (serialManager->protocolVersion() < 2) {
+        serialManager->requestProtocolVersion(2);
+    }
+    ProtocolFrame config = ProtocolEncoder::encodeBurstConfig(uint16_t(qBound(1, divider, 0xFFFF)),
+                                                              m_channelIds.constData(), m_channelIds.size());
+    if (!serialManager->pushFrame(config)) {
+        emit logMessage("突发捕获：配置命令入队失败");
+        return false;
+    }
+    setState(Configuring);
+    m_chunkTimer->start(); // 配置应答超时
+    return true;
+}
+
+void BurstCaptureManager::abortCapture()
+{
+    if (m_state < Configuring || m_state > Uploading) {
+        return;
+    }
+    static constexpr ProtocolFrame abortFrame = ProtocolEncoder::encodeBurstOp(BURST_CAPTURE_ABORT);
+    SerialCommunicationManager::getInstance()->pushFrame(abortFrame);
+    fail("已中止");
+}
+
+int BurstCaptureManager::fillSeries(QAbstractSeries *series, int channel) const
+{
+    QXYSeries *xySeries = qobject_cast<QXYSeries*>(series);
+    if (!xySeries || m_state != Done || channel < 0 || channel >= m_channelIds.size()) {
+        return 0;
+    }
+
+    // 一次replace整体替换，避免逐点append触发多次重绘
+    QList<QPointF> points;
+    points.reserve(m_sampleCount);
+    double periodMs = m_samplePeriodNs / 1e6;
+    for (int k = 0; k < m_sampleCount; ++k) {
+        points.append(QPointF((k - m_triggerIndex) * periodMs, value(k, channel)));
+    }
+    xySeries->replace(points);
+    return points.size();
+}
+
+float BurstCaptureManager::value(int sample, int channel) const
+{
+    uint32_t bits = ProtocolDecoder::readU32(m_data.constData() + 4 * (sample * m_channelIds.size() + channel));
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void BurstCaptureManager::onFramesReceived(const QVector<RxFrame> &frames)
+{
+    if (m_state < Configuring || m_state > Uploading) {
+        return;
+    }
+    for (const RxFrame &frame : frames) {
+        if (frame.data[1] != CMD_BURST_CAPTURE) {
+            continue;
+        }
+        if (frame.data[2] == BURST_CAPTURE_READ) {
+            // v1数据块：[3..4]块号，[5]有效字节数，[6..11]数据
+            int index = frame.data[3] | (frame.data[4] << 8);
+            int length = qMin<int>(frame.data[5], BURST_CAPTURE_V1_CHUNK_BYTES);
+            storeChunk(index, frame.data + 6, length);
+        } else {
+            handleAck(frame.data);
+        }
+    }
+}
+
+void BurstCaptureManager::onBlocksReceived(const QVector<RxBlock> &blocks)
+{
+    if (m_state != Uploading) {
+        return;
+    }
+    for (const RxBlock &block : blocks) {
+        // v2数据块：载荷[0]子命令，[1..2]块号，其后为数据
+        if (block.cmd != CMD_BURST_CAPTURE || block.length < 3 || block.payload[0] != BURST_CAPTURE_READ) {
+            continue;
+        }
+        int index = block.payload[1] | (block.payload[2] << 8);
+        storeChunk(index, block.payload + 3, block.length - 3);
+    }
+}
+
+void BurstCaptureManager::handleAck(const uint8_t *frame)
+{
+    uint8_t op = frame[2];
+    uint8_t status = frame[3];
+    auto* serialManager = SerialCommunicationManager::getInstance();
+
+    switch (op) {
+        case BURST_CAPTURE_CONFIG: {
+            if (m_state != Configuring) {
+                return;
+            }
+            if (status != RESPONSE_OK) {
+                fail(QString("配置被拒绝（状态%1）").arg(status));
+                return;
+            }
+            m_samplePeriodNs = ProtocolDecoder::readU32(frame + 4);
+            m_depth = frame[8] | (frame[9] << 8);
+            if (m_samplePeriodNs <= 0 || m_depth <= 0) {
+                fail("配置应答无效");
+                return;
+            }
+            int preTrigger = qMin(m_depth - 1, m_depth * m_preTriggerPercent / 100);
+            uint32_t levelBits;
+            memcpy(&levelBits, &m_triggerLevel, sizeof(levelBits));
+            serialManager->pushFrame(ProtocolEncoder::encodeBurstArm(m_triggerMode, m_triggerChannel,
+                                                                     levelBits, uint16_t(preTrigger)));
+            m_chunkTimer->start();
+            break;
+        }
+        case BURST_CAPTURE_ARM:
+            if (m_state != Configuring) {
+                return;
+            }
+            if (status != RESPONSE_OK) {
+                fail(QString("启动被拒绝（状态%1）").arg(status));
+                return;
+            }
+            m_chunkTimer->stop();
+            setState(Armed);
+            m_pollTimer->start();
+            emit logMessage(QString("突发捕获已启动：%1通道，采样间隔%2us，每通道%3点")
+                            .arg(m_channelIds.size()).arg(m_samplePeriodNs / 1000.0).arg(m_depth));
+            break;
+        case BURST_CAPTURE_STATUS: {
+            if (m_state != Armed && m_state != Triggered) {
+                return;
+            }
+            uint8_t captureState = frame[4];
+            if (status != RESPONSE_OK || captureState == BURST_STATE_IDLE) {
+                fail("电机端捕获已中止");
+            } else if (captureState == BURST_STATE_TRIGGERED) {
+                setState(Triggered);
+            } else if (captureState == BURST_STATE_DONE) {
+                m_pollTimer->stop();
+                m_sampleCount = frame[5] | (frame[6] << 8);
+                m_triggerIndex = frame[7] | (frame[8] << 8);
+                beginUpload(frame[9] | (frame[10] << 8));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void BurstCaptureManager::beginUpload(int chunkCount)
+{
+    // 块大小随协议版本：电机按同一版本分块，块数必须与数据长度一致
+    bool v2 = SerialCommunicationManager::getInstance()->protocolVersion() >= 2;
+    m_chunkBytes = v2 ? BURST_CAPTURE_V2_CHUNK_BYTES : BURST_CAPTURE_V1_CHUNK_BYTES;
+    m_windowChunks = v2 ? BURST_V2_WINDOW_CHUNKS : BURST_V1_WINDOW_CHUNKS;
+    int totalBytes = m_sampleCount * m_channelIds.size() * 4;
+    if (m_sampleCount <= 0 || chunkCount != (totalBytes + m_chunkBytes - 1) / m_chunkBytes) {
+        fail(QString("数据块数不符（%1点，%2块）").arg(m_sampleCount).arg(chunkCount));
+        return;
+    }
+
+    m_data.fill(0, totalBytes);
+    m_chunkReceived.fill(false, chunkCount);
+    m_totalChunks = chunkCount;
+    m_receivedChunks = 0;
+    m_retransmittedChunks = 0;
+    m_nextChunk = 0;
+    m_stalls = 0;
+    setState(Uploading);
+    emit progressChanged();
+    requestNextWindow();
+}
+
+void BurstCaptureManager::storeChunk(int index, const uint8_t *data, int length)
+{
+    if (m_state != Uploading || index < 0 || index >= m_totalChunks) {
+        return;
+    }
+    m_stalls = 0;
+    int offset = index * m_chunkBytes;
+    if (!m_chunkReceived[index] && length == qMin(m_chunkBytes, int(m_data.size()) - offset)) {
+        memcpy(m_data.data() + offset, data, size_t(length));
+        m_chunkReceived[index] = true;
+        ++m_receivedChunks;
+        emit progressChanged();
+    }
+
+    if (m_receivedChunks == m_totalChunks) {
+        finishUpload();
+    } else if (index + 1 == m_windowEnd) {
+        requestNextWindow(); // 窗口最后一块已到，前面丢失的块留待补读
+    } else {
+        m_chunkTimer->start();
+    }
+}
+
+void BurstCaptureManager::requestNextWindow()
+{
+    int first;
+    int count;
+    if (m_nextChunk < m_totalChunks) {
+        first = m_nextChunk;
+        count = qMin(m_windowChunks, m_totalChunks - first);
+        m_nextChunk += count;
+    } else {
+        // 补读：从第一个缺失的块起，连续缺失的块合为一次请求
+        first = m_chunkReceived.indexOf(false);
+        if (first < 0) {
+            finishUpload();
+            return;
+        }
+        count = 1;
+        while (first + count < m_totalChunks && count < m_windowChunks && !m_chunkReceived[first + count]) {
+            ++count;
+        }
+        m_retransmittedChunks += count;
+    }
+
+    m_windowEnd = first + count;
+    SerialCommunicationManager::getInstance()->pushFrame(ProtocolEncoder::encodeBurstRead(uint16_t(first), uint16_t(count)),
+                                                         TX_PRIORITY_TELEMETRY);
+    m_chunkTimer->start();
+}
+
+void BurstCaptureManager::finishUpload()
+{
+    m_chunkTimer->stop();
+    setState(Done);
+    emit captureCompleted();
+    emit logMessage(QString("突发捕获完成：%1点 × %2通道，%3块（补读%4块）")
+                    .arg(m_sampleCount).arg(m_channelIds.size()).arg(m_totalChunks).arg(m_retransmittedChunks));
+}
+
+void BurstCaptureManager::onPollTimeout()
+{
+    static constexpr ProtocolFrame statusFrame = ProtocolEncoder::encodeBurstOp(BURST_CAPTURE_STATUS);
+    SerialCommunicationManager::getInstance()->pushFrame(statusFrame);
+}
+
+void BurstCaptureManager::onChunkTimeout()
+{
+    if (m_state == Configuring) {
+        fail("电机无应答（可能不支持突发捕获）");
+        return;
+    }
+    if (m_state != Uploading) {
+        return;
+    }
+    if (++m_stalls > BURST_MAX_STALLS) {
+        fail("分块读取超时");
+        return;
+    }
+    requestNextWindow();
+}
+
+void BurstCaptureManager::setState(BurstState state)
+{
+    if (m_state != state) {
+        m_state = state;
+        emit stateChanged();
+    }
+}
+
+void BurstCaptureManager::fail(const QString &reason)
+{
+    m_pollTimer->stop();
+    m_chunkTimer->stop();
+    setState(Failed);
+    emit logMessage("突发捕获失败：" + reason);
+}
@@ -0,0 +1,152 @@
+#ifndef BURST_CAPTURE_MANAGER_H
+#define BURST_CAPTURE_MANAGER_H
+
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+#include <QTimer>
+#include <QAbstractSeries>
+#include "serial_io_worker.h" // 协议帧结构RxFrame/RxBlock
+
+/**
+ * @brief 突发捕获管理器 - 让电机按电流环频率采样到片内RAM，再分块读回
+ * 对应QML中的BurstCaptureModule
+ *
+ * 流程：配置通道与分频 -> 设置触发并启动 -> 轮询状态直到采集完成 -> 按窗口分块读取。
+ * 每次只有一个读取窗口在途，窗口最后一块到达后请求下一窗口；一轮读完后按位图重新读取
+ * 丢失的块，长时间没有数据块到达时也按位图补读。数据按块号直接写入缓冲区对应位置。
+ */
+class BurstCaptureManager : public QObject
+{
+    Q_OBJECT
+
+    // 可捕获的变量（电流环变量）
+    Q_PROPERTY(QStringList availableChannels READ availableChannels CONSTANT)
+
+    // 捕获状态：BurstState枚举值及对应文字
+    Q_PROPERTY(int state READ state NOTIFY stateChanged)
+    Q_PROPERTY(QString stateText READ stateText NOTIFY stateChanged)
+
+    // 读取进度（0~1）、已收块数/总块数、补读的块数
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(int receivedChunks READ receivedChunks NOTIFY progressChanged)
+    Q_PROPERTY(int totalChunks READ totalChunks NOTIFY progressChanged)
+    Q_PROPERTY(int retransmittedChunks READ retransmittedChunks NOTIFY progressChanged)
+
+    // 捕获结果：通道名、每通道点数、触发点序号、采样间隔（微秒）
+    Q_PROPERTY(QStringList channelNames READ channelNames NOTIFY captureCompleted)
+    Q_PROPERTY(int sampleCount READ sampleCount NOTIFY captureCompleted)
+    Q_PROPERTY(int triggerIndex READ triggerIndex NOTIFY captureCompleted)
+    Q_PROPERTY(double samplePeriodUs READ samplePeriodUs NOTIFY captureCompleted)
+
+public:
+    enum BurstState {
+        Idle = 0,       // 未开始
+        Configuring,    // 等待配置/启动应答
+        Armed,          // 等待触发
+        Triggered,      // 已触发，电机正在采集
+        Uploading,      // 分块读取中
+        Done,           // 读取完成
+        Failed          // 失败或已中止
+    };
+    Q_ENUM(BurstState)
+
+    static BurstCaptureManager* getInstance();
+
+    QStringList availableChannels() const;
+    int state() const { return m_state; }
+    QString stateText() const;
+    double progress() const { return m_totalChunks > 0 ? double(m_receivedChunks) / m_totalChunks : 0.0; }
+    int receivedChunks() const { return m_receivedChunks; }
+    int totalChunks() const { return m_totalChunks; }
+    int retransmittedChunks() const { return m_retransmittedChunks; }
+    QStringList channelNames() const { return m_channelNames; }
+    int sampleCount() const { return m_sampleCount; }
+    int triggerIndex() const { return m_triggerIndex; }
+    double samplePeriodUs() const { return m_samplePeriodNs / 1000.0; }
+
+    /**
+     * @brief 启动一次突发捕获
+     * @param channels 变量名（availableChannels中的1~6个）
+     * @param divider 采样分频（1为每个电流环周期采样一次）
+     * @param triggerMode 触发方式（burst_trigger_mode_t）
+     * @param triggerChannel 触发通道在channels中的序号
+     * @param triggerLevel 触发电平
+     * @param preTriggerPercent 预触发点数占总点数的百分比
+     * @return 是否已发送配置与启动命令
+     */
+    Q_INVOKABLE bool startCapture(const QStringList &channels, int divider, int triggerMode,
+                                  int triggerChannel, double triggerLevel, int preTriggerPercent);
+
+    // 中止捕获或读取
+    Q_INVOKABLE void abortCapture();
+
+    // 把第channel个通道的捕获结果整体替换进曲线（横轴为相对触发点的毫秒数），返回点数
+    Q_INVOKABLE int fillSeries(QAbstractSeries *series, int channel) const;
+
+    // 第channel个通道第sample个样本的值
+    float value(int sample, int channel) const;
+
+    // 批量协议帧处理：配置/启动/状态应答与v1数据块
+    void onFramesReceived(const QVector<RxFrame> &frames);
+
+    // v2数据块
+    void onBlocksReceived(const QVector<RxBlock> &blocks);
+
+signals:
+    void stateChanged();
+    void progressChanged();
+    void captureCompleted();
+    void logMessage(const QString &message);
+
+private slots:
+    void onPollTimeout();
+    void onChunkTimeout();
+
+private:
+    explicit BurstCaptureManager(QObject *parent = nullptr);
+    BurstCaptureManager(const BurstCaptureManager&) = delete;
+    BurstCaptureManager& operator=(const BurstCaptureManager&) = delete;
+
+    void handleAck(const uint8_t *frame);
+    void beginUpload(int chunkCount);
+    void storeChunk(int index, const uint8_t *data, int length);
+    void requestNextWindow();
+    void finishUpload();
+    void setState(BurstState state);
+    void fail(const QString &reason);
+
+    static BurstCaptureManager* m_instance;
+
+    BurstState m_state;
+    QStringList m_channelNames;
+    QVector<uint8_t> m_channelIds;
+    // 触发设置：预触发点数要等配置应答给出每通道点数后才能确定，届时再发送启动命令
+    uint8_t m_triggerMode;
+    uint8_t m_triggerChannel;
+    float m_triggerLevel;
+    int m_preTriggerPercent;
+
+    // 电机返回的参数
+    qint64 m_samplePeriodNs;
+    int m_depth;
+    int m_sampleCount;
+    int m_triggerIndex;
+
+    // 分块读取
+    int m_chunkBytes;                 // 每块字节数（随协议版本）
+    int m_windowChunks;               // 每次读取请求的块数
+    int m_totalChunks;
+    int m_receivedChunks;
+    int m_retransmittedChunks;
+    int m_nextChunk;                  // 首轮读取的下一个块号，等于m_totalChunks后进入补读
+    int m_windowEnd;                  // 在途窗口的结束块号（不含）
+    int m_stalls;                     // 连续无数据块的超时次数
+    QVector<uint8_t> m_data;          // 捕获数据（按样本顺序，每样本按通道顺序4字节）
+    QVector<bool> m_chunkReceived;
+
+    QTimer *m_pollTimer;              // 等待触发/采集完成时周期查询状态
+    QTimer *m_chunkTimer;             // 数据块到达超时
+};
+
+#endif // BURST_CAPTURE_MANAGER_H
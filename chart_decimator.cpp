@@ -0,0 +1,182 @@
+#include "chart_decimator.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+namespace ChartDecimator {
+
+/*
+ * 最小/最大值下标
+ * - 先只求最小值与最大值：SSE2每次处理4个double（两组min/max累加器，无分支），其余平台逐个比较
+ * - 再从头找两者第一次出现的位置，两个都找到即停止
+ * NaN不参与比较；全为NaN时两个下标都为0
+ */
+void minMaxIndex(const double *values, int count, int &minIndex, int &maxIndex)
+{
+    double mn = std::numeric_limits<double>::infinity();
+    double mx = -std::numeric_limits<double>::infinity();
+    int i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    if (count >= 4) {
+        // _mm_min_pd(a, b)在任一操作数为NaN时返回b，累加器放在第二个操作数上使NaN被忽略
+        __m128d mn0 = _mm_set1_pd(mn), mn1 = mn0;
+        __m128d mx0 = _mm_set1_pd(mx), mx1 = mx0;
+        for (; i + 4 <= count; i += 4) {
+            __m128d a = _mm_loadu_pd(values + i);
+            __m128d b = _mm_loadu_pd(values + i + 2);
+            mn0 = _mm_min_pd(a, mn0);
+            mn1 = _mm_min_pd(b, mn1);
+            mx0 = _mm_max_pd(a, mx0);
+            mx1 = _mm_max_pd(b, mx1);
+        }
+        mn0 = _mm_min_pd(mn0, mn1);
+        mx0 = _mm_max_pd(mx0, mx1);
+        mn0 = _mm_min_pd(mn0, _mm_unpackhi_pd(mn0, mn0));
+        mx0 = _mm_max_pd(mx0, _mm_unpackhi_pd(mx0, mx0));
+        mn = _mm_cvtsd_f64(mn0);
+        mx = _mm_cvtsd_f64(mx0);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        double v = values[i];
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+    }
+
+    minIndex = -1;
+    maxIndex = -1;
+    for (i = 0; i < count && (minIndex < 0 || maxIndex < 0); ++i) {
+        if (minIndex < 0 && values[i] == mn) {
+            minIndex = i;
+        }
+        if (maxIndex < 0 && values[i] == mx) {
+            maxIndex = i;
+        }
+    }
+    if (minIndex < 0) minIndex = 0;
+    if (maxIndex < 0) maxIndex = 0;
+}
+
+int decimate(const qint64 *times, const double *values, int count,
+             qint64 fromNs, qint64 toNs, int columns, qint64 originNs, QList<QPointF> &out)
+{
+    int start = int(out.size());
+    auto emitPoint = [&](int k) {
+        out.append(QPointF((times[k] - originNs) * 1e-6, values[k]));
+    };
+
+    // 窗口前后多取的点原样输出，中间为窗口内的样本
+    int i = 0;
+    while (i < count && times[i] < fromNs) {
+        emitPoint(i++);
+    }
+    int end = count;
+    while (end > i && times[end - 1] > toNs) {
+        --end;
+    }
+
+    if (columns <= 0 || toNs <= fromNs || end - i <= columns * POINTS_PER_COLUMN) {
+        // 点数不多，不抽点
+        for (; i < end; ++i) {
+            emitPoint(i);
+        }
+    } else {
+        double span = double(toNs - fromNs);
+        for (int c = 0; c < columns && i < end; ++c) {
+            // 本列的样本是时间落在列右边界之前的一段连续样本，二分查找边界
+            qint64 colEnd = (c == columns - 1) ? toNs + 1 : fromNs + qint64(span * (c + 1) / columns);
+            int j = int(std::lower_bound(times + i, times + end, colEnd) - times);
+            int n = j - i;
+            if (n <= POINTS_PER_COLUMN) {
+                for (int k = i; k < j; ++k) {
+                    emitPoint(k);
+                }
+            } else {
+                // 首点、最小、最大、末点按时间顺序输出，重合的点只输出一次
+                int minIndex, maxIndex;
+                minMaxIndex(values + i, n, minIndex, maxIndex);
+                int lo = i + std::min(minIndex, maxIndex);
+                int hi = i + std::max(minIndex, maxIndex);
+                emitPoint(i);
+                if (lo != i && lo != j - 1) {
+                    emitPoint(lo);
+                }
+                if (hi != lo && hi != j - 1) {
+                    emitPoint(hi);
+                }
+                if (j - 1 != i) {
+                    emitPoint(j - 1);
+                }
+            }
+            i = j;
+        }
+    }
+
+    for (i = end; i < count; ++i) {
+        emitPoint(i);
+    }
+    return int(out.size()) - start;
+}
+
+int decimateBuckets(const TimeSeriesStore::Bucket *buckets, int count,
+                    qint64 fromNs, qint64 toNs, int columns, qint64 originNs, QList<QPointF> &out)
+{
+    using Bucket = TimeSeriesStore::Bucket;
+    int start = int(out.size());
+    auto emitPoint = [&](qint64 ns, double value) {
+        out.append(QPointF((ns - originNs) * 1e-6, value));
+    };
+    auto midNs = [](const Bucket &b) {
+        return b.firstNs + (b.lastNs - b.firstNs) / 2;
+    };
+
+    int i = 0;
+    while (i < count && buckets[i].lastNs < fromNs) {
+        emitPoint(midNs(buckets[i]), buckets[i].mean);
+        ++i;
+    }
+    int end = count;
+    while (end > i && buckets[end - 1].firstNs > toNs) {
+        --end;
+    }
+
+    double span = double(std::max<qint64>(1, toNs - fromNs));
+    columns = std::max(1, columns);
+    for (int c = 0; c < columns && i < end; ++c) {
+        // 桶按首样本时刻归列
+        qint64 colEnd = (c == columns - 1) ? toNs + 1 : fromNs + qint64(span * (c + 1) / columns);
+        int j = int(std::lower_bound(buckets + i, buckets + end, colEnd,
+                                     [](const Bucket &b, qint64 t) { return b.firstNs < t; }) - buckets);
+        if (j == i) {
+            continue;
+        }
+        int minIndex = i;
+        int maxIndex = i;
+        for (int k = i + 1; k < j; ++k) {
+            if (buckets[k].min < buckets[minIndex].min) minIndex = k;
+            if (buckets[k].max > buckets[maxIndex].max) maxIndex = k;
+        }
+        emitPoint(buckets[i].firstNs, buckets[i].mean);
+        if (minIndex <= maxIndex) {
+            emitPoint(midNs(buckets[minIndex]), buckets[minIndex].min);
+            emitPoint(midNs(buckets[maxIndex]), buckets[maxIndex].max);
+        } else {
+            emitPoint(midNs(buckets[maxIndex]), buckets[maxIndex].max);
+            emitPoint(midNs(buckets[minIndex]), buckets[minIndex].min);
+        }
+        emitPoint(buckets[j - 1].lastNs, buckets[j - 1].mean);
+        i = j;
+    }
+
+    for (i = end; i < count; ++i) {
+        emitPoint(midNs(buckets[i]), buckets[i].mean);
+    }
+    return int(out.size()) - start;
+}
+
+} // namespace ChartDecimator
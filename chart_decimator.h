@@ -0,0 +1,54 @@
+#ifndef CHART_DECIMATOR_H
+#define CHART_DECIMATOR_H
+
+#include <QList>
+#include <QPointF>
+#include "time_series_store.h" // 汇总桶
+
+/**
+ * @brief 按像素列的M4抽点 - 送给曲线的点数只与绘图区宽度有关
+ *
+ * 可见时间窗按绘图区宽度分成像素列，每列只保留首点、最小值点、最大值点、末点（按时间顺序），
+ * 折线在每列内的纵向范围与连接关系和原始数据画出来完全相同，尖峰不会被抽掉。
+ * - 时间列须单调不减（TimeSeriesStore保证）
+ * - 窗口外的点（切片两端为连线到边缘多取的点）原样输出
+ * - 点数不超过4倍像素列时不抽点
+ */
+namespace ChartDecimator {
+
+// 每像素列最多输出的点数
+constexpr int POINTS_PER_COLUMN = 4;
+
+// 数据源每像素列超过该数目时改用更粗一级的汇总（抽点耗时与像素数成正比）
+constexpr int SOURCE_ITEMS_PER_COLUMN = 16;
+
+/**
+ * @brief 对一段样本按像素列做M4抽点，结果追加到out
+ * @param times 时间列（单调时钟纳秒）
+ * @param values 数值列
+ * @param count 样本数
+ * @param fromNs 可见窗口起点
+ * @param toNs 可见窗口终点
+ * @param columns 绘图区宽度（像素列数）
+ * @param originNs 横轴原点，输出的x为相对原点的毫秒数
+ * @param out 输出点
+ * @return 输出的点数
+ */
+int decimate(const qint64 *times, const double *values, int count,
+             qint64 fromNs, qint64 toNs, int columns, qint64 originNs, QList<QPointF> &out);
+
+/**
+ * @brief 对一段汇总桶按像素列抽点（缩小到原始样本已过期或点数过多时使用）
+ *
+ * 每列输出首桶均值、最小值、最大值、末桶均值四点（最小/最大值放在所在桶的中点时刻），
+ * 窗口外的桶输出其中点时刻的均值。参数含义同decimate()。
+ */
+int decimateBuckets(const TimeSeriesStore::Bucket *buckets, int count,
+                    qint64 fromNs, qint64 toNs, int columns, qint64 originNs, QList<QPointF> &out);
+
+// 一段数值中最小值与最大值第一次出现的下标（count须大于0）
+void minMaxIndex(const double *values, int count, int &minIndex, int &maxIndex);
+
+} // namespace ChartDecimator
+
+#endif // CHART_DECIMATOR_H
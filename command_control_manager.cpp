@@ -95,10 +95,27 @@ bool CommandControlManager::stopMotor()
 
 bool CommandControlManager::emergencyStop()
 {
-    qWarning() << "emergencyStop: 功能未实现";
-    emit errorOccurred("emergencyStop: 功能未实现");
-    emit commandCompleted("emergencyStop", false);
-    return false;
+    auto* serialManager = SerialCommunicationManager::getInstance();
+    
+    if (!serialManager->isConnected()) {
+        emit errorOccurred("串口未连接");
+        emit commandCompleted("emergencyStop", false);
+        return false;
+    }
+
+    // 停机命令走安全优先级：越过已排队的周期读取和设定值，立即写出
+    // 命令帧编译期生成（数据区全0），入队不分配内存
+    static constexpr ProtocolFrame stopFrame = ProtocolEncoder::encodeCommand(CMD_MOTOR_STOP);
+    bool success = serialManager->pushFrame(stopFrame, TX_PRIORITY_SAFETY);
+    
+    if (success) {
+        qDebug() << "快速停止命令已发送";
+    } else {
+        qWarning() << "快速停止命令发送失败";
+        emit errorOccurred("快速停止命令发送失败");
+    }
+    emit commandCompleted("emergencyStop", success);
+    return success;
 }
 
 bool CommandControlManager::clearErrors()
@@ -117,20 +134,13 @@ bool CommandControlManager::resetSystem()
     return false;
 }
 
-bool CommandControlManager::sendCommand(motor_command_t cmd, const QByteArray &data)
+bool CommandControlManager::sendCommand(motor_command_t cmd, const QByteArray &data, int priority)
 {
     auto* serialManager = SerialCommunicationManager::getInstance();
     
-    // 确保数据长度为10字节
-    QByteArray sendData = data;
-    if (sendData.size() < 10) {
-        sendData.resize(10);
-        sendData.fill(0);
-    } else if (sendData.size() > 10) {
-        sendData = sendData.left(10);
-    }
-
-    return serialManager->pushCmd(sendData, cmd);
+    // 数据区取前10字节，不足部分补0
+    return serialManager->pushFrame(ProtocolEncoder::encode(uint8_t(cmd), reinterpret_cast<const uint8_t*>(data.constData()),
+                                                            qMin(int(data.size()), PROTOCOL_DATA_LENGTH)), priority);
 }
 
 QByteArray CommandControlManager::createCalibrationData()
@@ -209,11 +219,8 @@ QByteArray CommandControlManager::createEmergencyStopData()
 {
     QByteArray data(10, 0);
     
-    // 快速停止命令数据格式
-    // byte 0: 命令类型 - 快速停止
-    data[0] = 0x03;  // EMERGENCY_STOP命令
-    
-    // byte 1-9: 快速停止参数（保留）
+    // 快速停止使用停止电机命令（CMD_MOTOR_STOP），协议规定数据区10字节全部填充0
+    data[0] = 0x00;
     data[1] = 0x00;
     data[2] = 0x00;
     data[3] = 0x00;
@@ -109,9 +109,10 @@ private slots:
      * @brief 发送命令到串口
      * @param cmd 命令类型
      * @param data 数据数组（10字节）
+     * @param priority 发送优先级（TxPriority），默认按命令字确定
      * @return 是否成功发送
      */
-    bool sendCommand(motor_command_t cmd, const QByteArray &data = QByteArray(10, 0));
+    bool sendCommand(motor_command_t cmd, const QByteArray &data = QByteArray(10, 0), int priority = -1);
 
     /**
      * @brief 创建校准数据包
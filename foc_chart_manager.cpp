@@ -1,11 +1,33 @@
 #include "foc_chart_manager.h"
 #include "serial_communication_manager.h"
+#include "chart_decimator.h"
 #include <QDebug>
 #include <QRandomGenerator>
+#include <limits>
+#include <cstring>
+
+FOCChartManager* FOCChartManager::m_instance = nullptr;
+
+FOCChartManager* FOCChartManager::getInstance()
+{
+    if (!m_instance) {
+        m_instance = new FOCChartManager();
+    }
+    return m_instance;
+}
 
 FOCChartManager::FOCChartManager(QObject *parent)
     : QObject(parent)
+    , m_readBurstsRejected(0)
+    , m_readQueueBlocked(false)
+    , m_streamingMode(false)        // 默认周期读取
+    , m_streamPeriodUs(10000)       // 订阅上报周期10ms，与周期读取相同
     , m_isCollecting(false)  // 默认不开启采集
+    , m_timeOriginNs(monotonicNowNs()) // 曲线时间从创建时开始计
+    , m_seriesStatStartNs(0)
+    , m_seriesUpdateUs(0.0)
+    , m_seriesUpdateMaxUs(0.0)
+    , m_sampleMemoryBytes(0)
     , m_debugTimer(nullptr)  // 调试定时器
     , m_debugStartTime(0)    // 调试开始时间
     , m_debugSineWaveRunning(false) // 调试正弦波未运行
@@ -14,9 +36,7 @@ FOCChartManager::FOCChartManager(QObject *parent)
     // 初始化变量列表和颜色映射
     initializeAvailableVariables();
     initializeVariableColors();
-    
-    // 初始化变量数值存储
-    m_variableValues.clear();
+    rebuildReadBurst();
     
     // 创建调试定时器
     m_debugTimer = new QTimer(this);
@@ -69,19 +89,19 @@ void FOCChartManager::addVariable(const QString &variableName)
         emit variableColorsChanged();
     }
     
-    // 为变量设置初始值0
-    m_variableValues[variableName] = 0.0;
-    
     m_selectedVariables.append(variableName);
+    rebuildReadBurst();
     emit selectedVariablesChanged();
     
-    log(QString("变量 '%1' 已添加到图表，初始值设置为: 0").arg(variableName));
+    log(QString("变量 '%1' 已添加到图表").arg(variableName));
     emit variableAdded(variableName, m_variableColors[variableName]);
 }
 
 void FOCChartManager::removeVariable(const QString &variableName)
 {
     if (m_selectedVariables.removeOne(variableName)) {
+        detachSeries(variableName);
+        rebuildReadBurst();
         emit selectedVariablesChanged();
         log(QString("Variable '%1' removed from chart").arg(variableName));
         emit variableRemoved(variableName);
@@ -227,9 +247,24 @@ void FOCChartManager::initializeAvailableVariables()
     // 初始化变量名到数据ID的映射
     initializeVariableToDataIdMapping();
     
+    // 可用变量确定后建立数据ID到存储通道的查找表
+    rebuildDataIdChannels();
+    
     log(QString("Available variables initialized: %1 variables").arg(m_availableVariables.size()));
 }
 
+void FOCChartManager::rebuildDataIdChannels()
+{
+    // 可用变量变化时重建：每个数据ID对应的变量在样本存储中的通道号，-1为忽略
+    m_dataIdToChannel.fill(-1);
+    for (int dataId = 0; dataId < int(m_dataIdToChannel.size()); ++dataId) {
+        QString variableName = getVariableNameFromDataId(uint8_t(dataId));
+        if (!variableName.isEmpty() && m_availableVariables.contains(variableName)) {
+            m_dataIdToChannel[dataId] = m_store.channel(variableName);
+        }
+    }
+}
+
 void FOCChartManager::initializeVariableToDataIdMapping()
 {
     // 变量名到数据ID的映射关系
@@ -331,19 +366,8 @@ void FOCChartManager::setIsCollecting(bool collecting)
     if (m_isCollecting) {
         log("开始采集数据");
         
-        // 为所有选中的变量设置初始值0
-        for (const QString &variableName : m_selectedVariables) {
-            if (!m_variableValues.contains(variableName)) {
-                m_variableValues[variableName] = 0.0;
-                log(QString("变量 '%1' 初始值设置为: 0").arg(variableName));
-            }
-        }
-        
-        // 发送读取变量指令
-        sendReadVariableCommands();
-        
-        // 启动读取指令定时器，实现实时数据采集
-        m_readCommandTimer->start();
+        // 开始向电机取数（周期读取或状态订阅）
+        startAcquisition();
         
         // 如果调试变量存在，自动启动调试正弦波信号发生器
         if (m_availableVariables.contains("调试正弦波")) {
@@ -351,8 +375,8 @@ void FOCChartManager::setIsCollecting(bool collecting)
         }
     } else {
         log("停止采集数据");
-        // 停止读取指令定时器
-        m_readCommandTimer->stop();
+        // 停止读取指令定时器或取消订阅
+        stopAcquisition();
         // 停止调试正弦波信号发生器
         stopDebugSineWave();
     }
@@ -363,11 +387,73 @@ void FOCChartManager::toggleCollection()
     setIsCollecting(!m_isCollecting);
 }
 
+void FOCChartManager::setStreamingMode(bool streaming)
+{
+    if (m_streamingMode == streaming)
+        return;
+    
+    // 采集中切换方式：先停止原方式再按新方式开始
+    if (m_isCollecting) {
+        stopAcquisition();
+    }
+    m_streamingMode = streaming;
+    if (m_isCollecting) {
+        startAcquisition();
+    }
+    log(QString("采集方式: %1").arg(streaming ? "状态订阅" : "周期读取"));
+    emit streamingModeChanged();
+}
+
+void FOCChartManager::setStreamPeriodUs(int periodUs)
+{
+    periodUs = qBound(100, periodUs, 0xFFFF * 100);
+    if (m_streamPeriodUs == periodUs)
+        return;
+    
+    m_streamPeriodUs = periodUs;
+    rebuildReadBurst();
+    emit streamingModeChanged();
+}
+
+void FOCChartManager::startAcquisition()
+{
+    if (m_streamingMode) {
+        // 订阅只需发送一次，之后由电机主动上报
+        SerialCommunicationManager* serialManager = SerialCommunicationManager::getInstance();
+        if (serialManager->isConnected()) {
+            // 尽量让电机按v2批量上报；不支持时无应答，继续使用v1上报帧
+            if (serialManager->protocolVersion() < 2) {
+                serialManager->requestProtocolVersion(2);
+            }
+            serialManager->pushFrames(m_subscribeBurst.constData(), m_subscribeBurst.size(), TX_PRIORITY_PARAM);
+        }
+    } else {
+        // 发送读取变量指令
+        sendReadVariableCommands();
+        
+        // 启动读取指令定时器，实现实时数据采集
+        m_readCommandTimer->start();
+    }
+}
+
+void FOCChartManager::stopAcquisition()
+{
+    m_readCommandTimer->stop();
+    if (m_streamingMode) {
+        SerialCommunicationManager* serialManager = SerialCommunicationManager::getInstance();
+        if (serialManager->isConnected()) {
+            static constexpr ProtocolFrame unsubscribeFrame =
+                ProtocolEncoder::encodeStatusSubscribe(STATUS_REPORT_UNSUBSCRIBE, 0, nullptr, 0);
+            serialManager->pushFrame(unsubscribeFrame, TX_PRIORITY_PARAM);
+        }
+    }
+}
+
 // 变量数值更新方法实现
-void FOCChartManager::updateVariableValue(const QString &variableName, double value)
+void FOCChartManager::updateVariableValue(const QString &variableName, double value, qint64 timestampNs)
 {
-    // 存储变量数值
-    m_variableValues[variableName] = value;
+    // 存储变量数值及其采样时刻
+    m_store.append(m_store.channel(variableName), timestampNs != 0 ? timestampNs : monotonicNowNs(), value);
     
     // 发出信号通知变量值已改变
     emit variableValueChanged(variableName, value);
@@ -378,13 +464,237 @@ void FOCChartManager::updateVariableValue(const QString &variableName, double va
 // 获取变量当前值方法实现
 double FOCChartManager::getVariableValue(const QString &variableName) const
 {
-    // 如果变量存在，返回其当前值；否则返回0.0
-    if (m_variableValues.contains(variableName)) {
-        return m_variableValues[variableName];
+    // 当前值即存储中最新的样本；变量不存在或还没有样本时返回0.0
+    int ch = m_store.findChannel(variableName);
+    if (ch < 0 || m_store.endSeq(ch) == m_store.beginSeq(ch)) {
+        return 0.0;
+    }
+    return m_store.valueAt(ch, m_store.endSeq(ch) - 1);
+}
+
+double FOCChartManager::getVariableTimeMs(const QString &variableName) const
+{
+    int ch = m_store.findChannel(variableName);
+    if (ch < 0 || m_store.endSeq(ch) == m_store.beginSeq(ch)) {
+        return -1.0;
+    }
+    return (m_store.timeAt(ch, m_store.endSeq(ch) - 1) - m_timeOriginNs) / 1000000.0;
+}
+
+qint64 FOCChartManager::sampleCursor(const QString &variableName) const
+{
+    int ch = m_store.findChannel(variableName);
+    return ch < 0 ? 0 : m_store.endSeq(ch);
+}
+
+QList<QPointF> FOCChartManager::readSamples(const QString &variableName, qint64 fromSeq, qint64 toSeq) const
+{
+    QList<QPointF> points;
+    int ch = m_store.findChannel(variableName);
+    if (ch < 0) {
+        return points;
+    }
+    fromSeq = qMax(fromSeq, m_store.beginSeq(ch));
+    toSeq = qMin(toSeq, m_store.endSeq(ch));
+    points.reserve(int(qMax<qint64>(0, toSeq - fromSeq)));
+    for (qint64 seq = fromSeq; seq < toSeq; ++seq) {
+        points.append(QPointF((m_store.timeAt(ch, seq) - m_timeOriginNs) / 1000000.0, m_store.valueAt(ch, seq)));
+    }
+    return points;
+}
+
+QList<QPointF> FOCChartManager::samplesInRange(const QString &variableName, double fromMs, double toMs) const
+{
+    int ch = m_store.findChannel(variableName);
+    if (ch < 0) {
+        return QList<QPointF>();
+    }
+    // 右端包含toMs：查找第一个晚于toMs的样本
+    qint64 from = m_store.lowerBound(ch, m_timeOriginNs + qint64(fromMs * 1000000.0));
+    qint64 to = m_store.lowerBound(ch, m_timeOriginNs + qint64(toMs * 1000000.0) + 1);
+    return readSamples(variableName, from, to);
+}
+
+void FOCChartManager::resetTimeOrigin()
+{
+    // 已存的样本保留，横轴从当前时刻重新计
+    m_timeOriginNs = monotonicNowNs();
+}
+
+void FOCChartManager::clearSamples()
+{
+    m_store.clear();
+    resetTimeOrigin();
+}
+
+void FOCChartManager::attachSeries(const QString &variableName, QAbstractSeries *series)
+{
+    QXYSeries *xySeries = qobject_cast<QXYSeries*>(series);
+    if (!xySeries) {
+        detachSeries(variableName);
+        return;
+    }
+    detachSeries(variableName);
+    SeriesFeed feed;
+    feed.name = variableName;
+    feed.series = xySeries;
+    m_seriesFeeds.append(feed);
+}
+
+void FOCChartManager::detachSeries(const QString &variableName)
+{
+    for (int i = 0; i < m_seriesFeeds.size(); ++i) {
+        if (m_seriesFeeds[i].name == variableName) {
+            m_seriesFeeds.remove(i);
+            return;
+        }
     }
-    
-    // 变量不存在，返回默认值0.0
-    return 0.0;
+}
+
+double FOCChartManager::refreshSeries(double fromMs, double toMs, int plotWidthPx)
+{
+    qint64 startNs = monotonicNowNs();
+    double latestMs = -1.0;
+    qint64 fromNs = m_timeOriginNs + qint64(fromMs * 1000000.0);
+    qint64 toNs = m_timeOriginNs + qint64(toMs * 1000000.0);
+
+    for (SeriesFeed &feed : m_seriesFeeds) {
+        if (!feed.series) {
+            continue; // 曲线已被QML销毁，等变量移除时清理
+        }
+        int ch = m_store.findChannel(feed.name);
+        qint64 from = 0;
+        qint64 to = 0;
+        int level = -1; // 数据源：-1为原始样本，否则为汇总金字塔的级别
+        if (ch >= 0) {
+            if (m_store.endSeq(ch) > m_store.beginSeq(ch)) {
+                latestMs = qMax(latestMs, (m_store.timeAt(ch, m_store.endSeq(ch) - 1) - m_timeOriginNs) / 1000000.0);
+            }
+            // 两端各多取一个窗口外的点，折线延伸到坐标轴边缘
+            from = qMax(m_store.beginSeq(ch), m_store.lowerBound(ch, fromNs) - 1);
+            to = qMin(m_store.endSeq(ch), m_store.lowerBound(ch, toNs + 1) + 1);
+
+            // 原始样本已不覆盖窗口起点（过期）或点数超出预算时，找第一个覆盖窗口且桶数在预算内的级别
+            qint64 budget = qint64(qMax(1, plotWidthPx)) * ChartDecimator::SOURCE_ITEMS_PER_COLUMN;
+            bool covered = m_store.droppedUntilNs(ch) < fromNs;
+            if (!covered || to - from > budget) {
+                for (int l = 0; l < TimeSeriesStore::PYRAMID_LEVELS; ++l) {
+                    qint64 begin = m_store.bucketBeginSeq(ch, l);
+                    qint64 bFrom = qMax(begin, m_store.bucketLowerBound(ch, l, fromNs) - 1);
+                    qint64 bTo = qMin(m_store.bucketEndSeq(ch, l), m_store.bucketLowerBound(ch, l, toNs + 1) + 1);
+                    bool levelCovered = m_store.bucketDroppedUntilNs(ch, l) < fromNs;
+                    if ((levelCovered && bTo - bFrom <= budget) || l == TimeSeriesStore::PYRAMID_LEVELS - 1) {
+                        level = l;
+                        from = bFrom;
+                        to = bTo;
+                        break;
+                    }
+                }
+            }
+        }
+        qint64 tail = ch >= 0 ? m_store.endSeq(ch) : 0;
+        if (level == feed.level && from == feed.fromSeq && to == feed.toSeq
+            && (level < 0 || tail == feed.tailSeq) && m_timeOriginNs == feed.originNs
+            && fromNs == feed.fromNs && toNs == feed.toNs && plotWidthPx == feed.columns) {
+            continue; // 窗口与样本都没变，曲线不动，也不触发重绘
+        }
+        feed.level = level;
+        feed.fromSeq = from;
+        feed.toSeq = to;
+        feed.tailSeq = tail;
+        feed.originNs = m_timeOriginNs;
+        feed.fromNs = fromNs;
+        feed.toNs = toNs;
+        feed.columns = plotWidthPx;
+
+        // 送给曲线的点数不超过每像素列4点（另加窗口两端各一点）
+        QList<QPointF> points;
+        if (level < 0) {
+            // 两列整块取出后再组装成点，比逐点按序号取模快
+            int count = int(qMax<qint64>(0, to - from));
+            m_sliceTimes.resize(count);
+            m_sliceValues.resize(count);
+            if (count > 0) {
+                count = m_store.read(ch, from, to, m_sliceTimes.data(), m_sliceValues.data());
+            }
+            points.reserve(qMin(count, plotWidthPx * ChartDecimator::POINTS_PER_COLUMN + 2));
+            ChartDecimator::decimate(m_sliceTimes.constData(), m_sliceValues.constData(), count,
+                                     fromNs, toNs, plotWidthPx, m_timeOriginNs, points);
+        } else {
+            collectBuckets(ch, level, from, to, fromNs, toNs);
+            points.reserve(plotWidthPx * ChartDecimator::POINTS_PER_COLUMN + 2);
+            ChartDecimator::decimateBuckets(m_sliceBuckets.constData(), m_sliceBuckets.size(),
+                                            fromNs, toNs, plotWidthPx, m_timeOriginNs, points);
+        }
+        feed.series->replace(points);
+    }
+
+    // 刷新耗时约每秒汇总一次
+    qint64 endNs = monotonicNowNs();
+    m_seriesUpdateStat.add(endNs - startNs);
+    if (endNs - m_seriesStatStartNs >= 1000000000LL) {
+        m_seriesUpdateUs = m_seriesUpdateStat.avgUs();
+        m_seriesUpdateMaxUs = m_seriesUpdateStat.maxUs();
+        m_seriesUpdateStat.reset();
+        m_seriesStatStartNs = endNs;
+        m_sampleMemoryBytes = m_store.memoryBytes();
+        emit seriesUpdateStatsChanged();
+    }
+    return latestMs;
+}
+
+void FOCChartManager::collectBuckets(int ch, int level, qint64 from, qint64 to, qint64 fromNs, qint64 toNs)
+{
+    m_sliceBuckets.resize(int(to - from));
+    int count = m_store.readBuckets(ch, level, from, to, m_sliceBuckets.data());
+    m_sliceBuckets.resize(count);
+
+    // 粗级别只含已完成的桶；其后尚未汇总完的部分依次由更细的级别和原始样本补上，每级最多15个
+    qint64 coveredNs = count > 0 ? m_sliceBuckets.last().lastNs : std::numeric_limits<qint64>::min();
+    if (coveredNs > toNs) {
+        return;
+    }
+    for (int l = level - 1; l >= 0; --l) {
+        qint64 begin = m_store.bucketBeginSeq(ch, l);
+        qint64 end = m_store.bucketEndSeq(ch, l);
+        qint64 seq = m_sliceBuckets.isEmpty() ? qMax(begin, m_store.bucketLowerBound(ch, l, fromNs) - 1)
+                                              : qMax(begin, m_store.bucketLowerBound(ch, l, coveredNs + 1));
+        end = qMin(end, m_store.bucketLowerBound(ch, l, toNs + 1) + 1);
+        for (; seq < end; ++seq) {
+            m_sliceBuckets.append(m_store.bucketAt(ch, l, seq));
+        }
+        if (!m_sliceBuckets.isEmpty()) {
+            coveredNs = m_sliceBuckets.last().lastNs;
+        }
+    }
+    qint64 seq = m_sliceBuckets.isEmpty() ? qMax(m_store.beginSeq(ch), m_store.lowerBound(ch, fromNs) - 1)
+                                          : qMax(m_store.beginSeq(ch), m_store.lowerBound(ch, coveredNs + 1));
+    qint64 end = qMin(m_store.endSeq(ch), m_store.lowerBound(ch, toNs + 1) + 1);
+    for (; seq < end; ++seq) {
+        TimeSeriesStore::Bucket sample;
+        sample.firstNs = sample.lastNs = m_store.timeAt(ch, seq);
+        sample.min = sample.max = sample.mean = m_store.valueAt(ch, seq);
+        m_sliceBuckets.append(sample);
+    }
+}
+
+void FOCChartManager::setRetentionSeconds(double seconds)
+{
+    qint64 maxAgeNs = qint64(qMax(0.0, seconds) * 1e9);
+    if (maxAgeNs == m_store.maxAgeNs()) {
+        return;
+    }
+    m_store.setRetention(m_store.maxSamples(), maxAgeNs);
+    emit retentionChanged();
+}
+
+void FOCChartManager::setRetentionSamples(int samples)
+{
+    if (samples < 1 || samples == m_store.maxSamples()) {
+        return;
+    }
+    m_store.setRetention(samples, m_store.maxAgeNs());
+    emit retentionChanged();
 }
 
 void FOCChartManager::updateDebugSineValue()
@@ -452,37 +762,90 @@ void FOCChartManager::stopDebugSineWave()
 }
 
 void FOCChartManager::onReadDataReceived(uint8_t dataId, uint32_t dataValue)
+{
+    // 没有帧到达时刻的来源（如QML直接调用）按当前时刻处理
+    onSampleReceived(dataId, dataValue, monotonicNowNs());
+}
+
+void FOCChartManager::onSampleReceived(uint8_t dataId, uint32_t dataValue, qint64 timestampNs)
 {
     // 检查采集状态，只有在采集状态下才处理数据
     if (!m_isCollecting) {
         return;
     }
     
-    // 根据数据ID映射到对应的变量名称
-    QString variableName = getVariableNameFromDataId(dataId);
-    
-    // 如果变量名称无效，则忽略该数据
-    if (variableName.isEmpty()) {
-        log(QString("未知数据ID: %1, 值: %2").arg(dataId).arg(dataValue));
-        return;
-    }
-    
-    // 检查变量是否在可用变量列表中
-    if (!m_availableVariables.contains(variableName)) {
-        log(QString("数据ID %1 对应的变量 '%2' 不在可用变量列表中").arg(dataId).arg(variableName));
+    // 数据ID直接查表得到样本存储的通道号，逐样本不构造变量名、不查哈希表
+    int ch = m_dataIdToChannel[dataId];
+    if (ch < 0) {
+        // 未知数据ID或变量不在可用列表中，只在这种少见情况下按名称查找用于日志
+        QString variableName = getVariableNameFromDataId(dataId);
+        if (variableName.isEmpty()) {
+            log(QString("未知数据ID: %1, 值: %2").arg(dataId).arg(dataValue));
+        } else {
+            log(QString("数据ID %1 对应的变量 '%2' 不在可用变量列表中").arg(dataId).arg(variableName));
+        }
         return;
     }
     
-    // 将32位无符号整数转换为double类型
-    double convertedValue = static_cast<double>(dataValue);
+    // 数据值是小端float的位模式（读数据应答、主动上报、v2数据块相同），按位还原后转为double
+    float floatValue;
+    memcpy(&floatValue, &dataValue, sizeof(floatValue));
+    double convertedValue = static_cast<double>(floatValue);
     
-    // 更新变量数值
-    updateVariableValue(variableName, convertedValue);
+    // 写入样本存储；曲线按序号取数，逐样本不发信号
+    m_store.append(ch, timestampNs, convertedValue);
     
     // 记录数据接收日志（避免过多输出，可以注释掉）
     // log(QString("接收到数据 - 变量: %1, ID: %2, 值: %3").arg(variableName).arg(dataId).arg(convertedValue));
 }
 
+void FOCChartManager::onFramesReceived(const QVector<RxFrame> &frames)
+{
+    // 检查采集状态，只有在采集状态下才处理数据
+    if (!m_isCollecting) {
+        return;
+    }
+    
+    // 一批帧中只处理读数据应答和状态主动上报，其余命令由各自的管理器处理
+    for (const RxFrame &frame : frames) {
+        if (frame.data[1] == CMD_READ_DATA) {
+            onSampleReceived(frame.data[2], ProtocolDecoder::readU32(frame.data + 3), frame.rxNs);
+        } else if (ProtocolDecoder::isStatusStream(frame.data)) {
+            // 每个上报帧携带1~2个数据，与读数据应答走同一处理流程
+            uint8_t ids[2];
+            uint32_t values[2];
+            int count = ProtocolDecoder::decodeStatusStream(frame.data, ids, values);
+            for (int i = 0; i < count; ++i) {
+                onSampleReceived(ids[i], values[i], frame.rxNs);
+            }
+        }
+    }
+}
+
+void FOCChartManager::onBlocksReceived(const QVector<RxBlock> &blocks)
+{
+    if (!m_isCollecting) {
+        return;
+    }
+    
+    // v2批量数据块：逐样本、逐通道走与v1上报相同的处理流程
+    // 块随最后一个样本发出，之前的样本按采样周期从块到达时刻往前推
+    for (const RxBlock &block : blocks) {
+        ProtocolDecoder::SampleBlock samples;
+        if (block.cmd != CMD_STATUS_SUBSCRIBE
+            || !ProtocolDecoder::decodeSampleBlock(block.payload, block.length, samples)) {
+            continue;
+        }
+        qint64 periodNs = qint64(samples.periodUs) * 1000;
+        for (int s = 0; s < samples.samples; ++s) {
+            qint64 sampleNs = block.rxNs - (samples.samples - 1 - s) * periodNs;
+            for (int c = 0; c < samples.channels; ++c) {
+                onSampleReceived(samples.ids[c], samples.value(s, c), sampleNs);
+            }
+        }
+    }
+}
+
 QString FOCChartManager::getVariableNameFromDataId(uint8_t dataId)
 {
     // 数据ID到变量名称的映射表（基于协议定义）
@@ -550,37 +913,57 @@ QString FOCChartManager::getVariableNameFromDataId(uint8_t dataId)
     }
 }
 
+void FOCChartManager::rebuildReadBurst()
+{
+    // 选中变量变化时才重新编码，周期发送时直接整组入队
+    m_readBurst.clear();
+    uint8_t ids[STATUS_REPORT_MAX_IDS];
+    int idCount = 0;
+    for (const QString& variableName : m_selectedVariables) {
+        if (!m_variableToDataId.contains(variableName)) {
+            qDebug() << "未找到变量对应的数据ID:" << variableName;
+            continue;
+        }
+        uint8_t dataId = m_variableToDataId.value(variableName);
+        m_readBurst.append(ProtocolEncoder::encodeReadData(dataId));
+        if (idCount < STATUS_REPORT_MAX_IDS) {
+            ids[idCount++] = dataId;
+        }
+    }
+    
+    // 订阅请求：每包最多6个数据ID，无选中变量时为取消订阅
+    m_subscribeBurst.resize(qMax(1, (idCount + STATUS_REPORT_IDS_PER_REQUEST - 1) / STATUS_REPORT_IDS_PER_REQUEST));
+    ProtocolEncoder::encodeStatusSubscription(uint32_t(m_streamPeriodUs), ids, idCount,
+                                              m_subscribeBurst.data(), m_subscribeBurst.size());
+    
+    // 订阅方式采集中：选中变量或周期变化后重新订阅
+    if (m_isCollecting && m_streamingMode) {
+        startAcquisition();
+    }
+}
+
 void FOCChartManager::sendReadVariableCommands()
 {
     // 获取SerialCommunicationManager单例实例
     SerialCommunicationManager* serialManager = SerialCommunicationManager::getInstance();
     
     // 检查串口是否已连接
-    if (!serialManager->isConnected()) {
-        // qDebug() << "串口未连接，无法发送读取指令";
+    if (!serialManager->isConnected() || m_readBurst.isEmpty()) {
         return;
     }
     
-    // 遍历选中的变量列表，发送读取指令
-    for (const QString& variableName : m_selectedVariables) {
-        // 查找变量对应的数据ID
-        if (m_variableToDataId.contains(variableName)) {
-            quint8 dataId = m_variableToDataId[variableName];
-            
-            // 构建10字节数据区（数据ID + 9字节填充0）
-            QByteArray data(10, 0x00);
-            data[0] = dataId; // 第一个字节为数据ID
-            
-            // 发送读取指令
-            bool success = serialManager->pushCmd(data, CMD_READ_DATA);
-            
-            if (success) {
-                qDebug() << "发送读取指令成功，变量:" << variableName << "数据ID:" << QString("0x%1").arg(dataId, 2, 16, QChar('0'));
-            } else {
-                qDebug() << "发送读取指令失败，变量:" << variableName;
-            }
+    // 整组读取指令一次入队（帧已预先编码）
+    // 队列满时每个读取周期都会被拒绝：不发errorOccurred，只计数，进入和退出该状态时各打印一次
+    bool blocked = !serialManager->pushFrames(m_readBurst.constData(), m_readBurst.size(), -1, false);
+    if (blocked) {
+        ++m_readBurstsRejected;
+    }
+    if (blocked != m_readQueueBlocked) {
+        m_readQueueBlocked = blocked;
+        if (blocked) {
+            qDebug() << "命令队列已满，部分读取指令未能入队，变量数:" << m_readBurst.size();
         } else {
-            qDebug() << "未找到变量对应的数据ID:" << variableName;
+            qDebug() << "读取指令恢复入队，累计未能入队次数:" << m_readBurstsRejected;
         }
     }
-}
\ No newline at end of file
+}
@@ -12,7 +12,14 @@
 #include <QTimer>
 #include <QThread>
 #include <cmath>
+#include <array>
 #include "DOC/motor_protocol.h"  // 包含协议定义
+#include "serial_io_worker.h"      // 协议帧结构RxFrame
+#include "time_series_store.h"     // 收到的全部样本
+#include <QPointF>
+#include <QPointer>
+#include <QAbstractSeries>
+#include <QXYSeries>
 
 class FOCChartManager : public QObject
 {
@@ -46,11 +53,34 @@ class FOCChartManager : public QObject
     // 采集状态属性
     Q_PROPERTY(bool isCollecting READ isCollecting WRITE setIsCollecting NOTIFY isCollectingChanged)
     
+    // 采集方式：false为周期读取（主机每10ms逐个读），true为状态订阅（电机按周期主动上报）
+    Q_PROPERTY(bool streamingMode READ streamingMode WRITE setStreamingMode NOTIFY streamingModeChanged)
+    // 状态订阅上报周期（微秒，按0.1ms取整）
+    Q_PROPERTY(int streamPeriodUs READ streamPeriodUs WRITE setStreamPeriodUs NOTIFY streamingModeChanged)
+    
+    // 样本保留策略：每个变量最多保留的时长（秒）与样本数，两者先到者为准
+    Q_PROPERTY(double retentionSeconds READ retentionSeconds WRITE setRetentionSeconds NOTIFY retentionChanged)
+    Q_PROPERTY(int retentionSamples READ retentionSamples WRITE setRetentionSamples NOTIFY retentionChanged)
+    
+    // 曲线刷新耗时：每显示帧refreshSeries()的平均/最大耗时（微秒，约每秒更新）
+    Q_PROPERTY(double seriesUpdateUs READ seriesUpdateUs NOTIFY seriesUpdateStatsChanged)
+    Q_PROPERTY(double seriesUpdateMaxUs READ seriesUpdateMaxUs NOTIFY seriesUpdateStatsChanged)
+    
+    // 样本存储占用：全部变量当前字节数（随刷新耗时一起更新）与每个变量的上限
+    Q_PROPERTY(qint64 sampleMemoryBytes READ sampleMemoryBytes NOTIFY seriesUpdateStatsChanged)
+    Q_PROPERTY(qint64 channelMemoryLimitBytes READ channelMemoryLimitBytes NOTIFY retentionChanged)
+    
+    // 周期读取时命令队列已满、读取指令未能整组入队的次数（随刷新耗时一起更新）
+    Q_PROPERTY(qint64 readBurstsRejected READ readBurstsRejected NOTIFY seriesUpdateStatsChanged)
+    
 
 
 public:
     explicit FOCChartManager(QObject *parent = nullptr);
     
+    // 获取单例实例（QML单例与串口数据连接共用同一实例）
+    static FOCChartManager* getInstance();
+    
     // 获取可用变量列表
     QStringList availableVariables() const;
     
@@ -90,18 +120,74 @@ public:
     void setIsCollecting(bool collecting);
     Q_INVOKABLE void toggleCollection();
     
-    // 变量数值更新方法
-    Q_INVOKABLE void updateVariableValue(const QString &variableName, double value);
+    // 采集方式相关方法
+    bool streamingMode() const { return m_streamingMode; }
+    void setStreamingMode(bool streaming);
+    int streamPeriodUs() const { return m_streamPeriodUs; }
+    void setStreamPeriodUs(int periodUs);
+    
+    // 保留策略相关方法
+    double retentionSeconds() const { return m_store.maxAgeNs() / 1e9; }
+    void setRetentionSeconds(double seconds);
+    int retentionSamples() const { return m_store.maxSamples(); }
+    void setRetentionSamples(int samples);
+    
+    // 变量数值更新方法（timestampNs为采样时刻，单调时钟纳秒；0表示当前时刻）
+    // 每次更新都写入样本存储，曲线从存储中按序号取数
+    Q_INVOKABLE void updateVariableValue(const QString &variableName, double value, qint64 timestampNs = 0);
     
     // 获取变量当前值
     Q_INVOKABLE double getVariableValue(const QString &variableName) const;
     
+    // 获取变量当前值的采样时刻（相对时间原点的毫秒数，变量从未更新时返回-1）
+    Q_INVOKABLE double getVariableTimeMs(const QString &variableName) const;
+    
+    // 变量的样本序号游标：下一个写入样本的序号（变量从未更新时为0）
+    // 曲线记住上次取到的游标，下次从该处继续取，样本不漏不重
+    Q_INVOKABLE qint64 sampleCursor(const QString &variableName) const;
+    
+    // 取序号[fromSeq, toSeq)的样本，x为相对时间原点的毫秒数（已超出保留范围的部分跳过）
+    Q_INVOKABLE QList<QPointF> readSamples(const QString &variableName, qint64 fromSeq, qint64 toSeq) const;
+    
+    // 取时间范围[fromMs, toMs]内的样本（相对时间原点的毫秒数）
+    Q_INVOKABLE QList<QPointF> samplesInRange(const QString &variableName, double fromMs, double toMs) const;
+    
+    // 以当前时刻为时间原点重新计时
+    Q_INVOKABLE void resetTimeOrigin();
+    
+    // 丢弃已存的全部样本并重新计时（清空曲线时调用）
+    Q_INVOKABLE void clearSamples();
+    
+    // 把变量的曲线交给C++刷新（移除变量时自动解除）
+    Q_INVOKABLE void attachSeries(const QString &variableName, QAbstractSeries *series);
+    Q_INVOKABLE void detachSeries(const QString &variableName);
+    
+    // 每显示帧调用一次：按可见时间窗[fromMs, toMs]从样本存储切出各曲线的点，
+    // 按绘图区宽度plotWidthPx做M4抽点（每像素列最多4点）后用一次replace()整体替换；
+    // 返回所有曲线中最新样本的时间（毫秒，无样本为-1）
+    Q_INVOKABLE double refreshSeries(double fromMs, double toMs, int plotWidthPx);
+    
+    double seriesUpdateUs() const { return m_seriesUpdateUs; }
+    double seriesUpdateMaxUs() const { return m_seriesUpdateMaxUs; }
+    qint64 sampleMemoryBytes() const { return m_sampleMemoryBytes; }
+    qint64 channelMemoryLimitBytes() const { return m_store.channelMemoryLimit(); }
+    qint64 readBurstsRejected() const { return m_readBurstsRejected; }
+    
     // 调试变量信号发生器控制方法
     Q_INVOKABLE void startDebugSineWave();
     Q_INVOKABLE void stopDebugSineWave();
     
     // 串口数据接收处理槽函数
     Q_INVOKABLE void onReadDataReceived(uint8_t dataId, uint32_t dataValue);
+    
+    // 带接收时刻的数据处理（dataValue为小端float的位模式，timestampNs为帧到达时刻，单调时钟纳秒）
+    void onSampleReceived(uint8_t dataId, uint32_t dataValue, qint64 timestampNs);
+    
+    // 批量协议帧处理（每次取帧调用一次）
+    void onFramesReceived(const QVector<RxFrame> &frames);
+    
+    // v2批量数据块处理（协商到v2后的状态上报）
+    void onBlocksReceived(const QVector<RxBlock> &blocks);
 
 signals:
     void availableVariablesChanged();
@@ -115,7 +201,10 @@ signals:
     void viewRangeChanged();
     void dataLengthMsChanged();
     void isCollectingChanged();
-    void variableValueChanged(const QString &variableName, double value);
+    void streamingModeChanged();
+    void retentionChanged();
+    void seriesUpdateStatsChanged();
+    void variableValueChanged(const QString &variableName, double value); // 只由updateVariableValue()发出，电机样本逐样本写入存储不发信号
 
 private:
     // 初始化可用变量列表
@@ -130,6 +219,16 @@ private:
     // 发送读取变量指令
     void sendReadVariableCommands();
     
+    // 按选中变量重新生成整组读取指令与订阅请求
+    void rebuildReadBurst();
+    
+    // 汇总桶数据源：取第level级[from, to)的桶，并用更细级别和原始样本补齐其后未汇总完的部分
+    void collectBuckets(int ch, int level, qint64 from, qint64 to, qint64 fromNs, qint64 toNs);
+    
+    // 按当前采集方式开始/停止向电机取数
+    void startAcquisition();
+    void stopAcquisition();
+    
     // 生成随机颜色
     QColor generateRandomColor() const;
     
@@ -141,16 +240,50 @@ private:
     
     // 数据ID到变量名称映射方法
     QString getVariableNameFromDataId(uint8_t dataId);
+    void rebuildDataIdChannels(); // 重建数据ID到存储通道号的查找表
+    
+    static FOCChartManager* m_instance;    // 单例实例
     
     QStringList m_availableVariables;      // 所有可用的变量
     QStringList m_selectedVariables;       // 当前选中的变量
     QHash<QString, QColor> m_variableColors; // 变量颜色映射
     QHash<QString, quint8> m_variableToDataId; // 变量名到数据ID的映射
+    std::array<int, 256> m_dataIdToChannel;    // 数据ID到样本存储通道号（-1为未知或不可用的ID）
+    QVector<ProtocolFrame> m_readBurst;     // 选中变量的读取指令（预先编码，连续存放）
+    qint64 m_readBurstsRejected;            // 命令队列满、未能整组入队的读取次数
+    bool m_readQueueBlocked;                // 上次读取未能整组入队（只在状态变化时打印日志）
+    QVector<ProtocolFrame> m_subscribeBurst; // 选中变量的状态订阅请求（无选中变量时为取消订阅）
+    bool m_streamingMode;                   // 状态订阅方式采集
+    int m_streamPeriodUs;                   // 状态订阅上报周期（微秒）
     ViewState m_viewState;                  // 视图状态
     bool m_isCollecting;                    // 采集状态
     
     // 变量数值存储
-    QHash<QString, double> m_variableValues;
+    TimeSeriesStore m_store;                 // 各变量收到的全部样本（时间戳为单调时钟纳秒）
+    qint64 m_timeOriginNs;                   // 曲线时间轴的原点
+    
+    // 由C++刷新的曲线：记下上次切片的数据源、序号范围与抽点参数，都不变时不替换
+    struct SeriesFeed {
+        QString name;
+        QPointer<QXYSeries> series;
+        int level = -2;
+        qint64 tailSeq = -1;
+        qint64 fromSeq = -1;
+        qint64 toSeq = -1;
+        qint64 originNs = 0;
+        qint64 fromNs = 0;
+        qint64 toNs = 0;
+        int columns = 0;
+    };
+    QVector<SeriesFeed> m_seriesFeeds;
+    QVector<qint64> m_sliceTimes;            // 切片暂存（各曲线复用）
+    QVector<double> m_sliceValues;
+    QVector<TimeSeriesStore::Bucket> m_sliceBuckets;
+    LatencyStat m_seriesUpdateStat;          // 统计窗口内每帧刷新耗时
+    qint64 m_seriesStatStartNs;
+    double m_seriesUpdateUs;
+    double m_seriesUpdateMaxUs;
+    qint64 m_sampleMemoryBytes;
     
     // 调试变量相关成员
     QTimer* m_debugTimer;                  // 调试定时器
@@ -0,0 +1,132 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief 定长对象池 + 基于下标的单向链表
+ *
+ * 用于发送队列：所有待发送/在途的命令都存放在预分配的槽位中，
+ * 各优先级通道与在途列表只是串起槽位下标的链表，入队、出队、重排都不分配内存。
+ * - 非线程安全，由调用方加锁
+ * - 槽位耗尽时acquire()返回NIL，由调用方决定丢弃或拒绝
+ */
+template <typename T, std::size_t Capacity>
+class FramePool
+{
+public:
+    static constexpr int NIL = -1;
+
+    // 槽位链表（只记录首尾下标，节点在池中）
+    struct List {
+        int head = NIL;
+        int tail = NIL;
+        int size = 0;
+
+        bool isEmpty() const { return head == NIL; }
+    };
+
+    FramePool() : m_freeHead(0), m_freeCount(int(Capacity))
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_nodes[i].next = (i + 1 < Capacity) ? int(i + 1) : NIL;
+        }
+    }
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 取出一个空闲槽位，池已空返回NIL
+    int acquire()
+    {
+        int idx = m_freeHead;
+        if (idx != NIL) {
+            m_freeHead = m_nodes[idx].next;
+            m_nodes[idx].next = NIL;
+            --m_freeCount;
+        }
+        return idx;
+    }
+
+    // 归还槽位（须已从所在链表移除）
+    void release(int idx)
+    {
+        m_nodes[idx].next = m_freeHead;
+        m_freeHead = idx;
+        ++m_freeCount;
+    }
+
+    T &operator[](int idx) { return m_nodes[idx].value; }
+    const T &operator[](int idx) const { return m_nodes[idx].value; }
+
+    // 链表中idx的下一个槽位
+    int next(int idx) const { return m_nodes[idx].next; }
+
+    void pushBack(List &list, int idx)
+    {
+        m_nodes[idx].next = NIL;
+        if (list.tail == NIL) {
+            list.head = idx;
+        } else {
+            m_nodes[list.tail].next = idx;
+        }
+        list.tail = idx;
+        ++list.size;
+    }
+
+    void pushFront(List &list, int idx)
+    {
+        m_nodes[idx].next = list.head;
+        list.head = idx;
+        if (list.tail == NIL) {
+            list.tail = idx;
+        }
+        ++list.size;
+    }
+
+    // 取出链表首个槽位，链表为空返回NIL
+    int popFront(List &list)
+    {
+        int idx = list.head;
+        if (idx != NIL) {
+            list.head = m_nodes[idx].next;
+            if (list.head == NIL) {
+                list.tail = NIL;
+            }
+            m_nodes[idx].next = NIL;
+            --list.size;
+        }
+        return idx;
+    }
+
+    // 移除链表中的idx，prev为其前一个槽位（idx为首个时传NIL）
+    void remove(List &list, int idx, int prev)
+    {
+        if (prev == NIL) {
+            list.head = m_nodes[idx].next;
+        } else {
+            m_nodes[prev].next = m_nodes[idx].next;
+        }
+        if (list.tail == idx) {
+            list.tail = prev;
+        }
+        m_nodes[idx].next = NIL;
+        --list.size;
+    }
+
+    int available() const { return m_freeCount; }
+    static constexpr int capacity() { return int(Capacity); }
+
+private:
+    struct Node {
+        T value;
+        int next;
+    };
+
+    std::array<Node, Capacity> m_nodes;
+    int m_freeHead;
+    int m_freeCount;
+};
+
+#endif // FRAME_POOL_H
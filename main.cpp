@@ -5,6 +5,7 @@
 #include "command_control_manager.h"
 #include "foc_chart_manager.h"
 #include "motor_mode_control_manager.h" // 添加电机模式控制管理器
+#include "burst_capture_manager.h"
 
 int main(int argc, char *argv[])
 {
@@ -32,7 +33,7 @@ int main(int argc, char *argv[])
                                              [](QQmlEngine *engine, QJSEngine *scriptEngine) -> QObject * {
                                                  Q_UNUSED(engine)
                                                  Q_UNUSED(scriptEngine)
-                                                 return new FOCChartManager();
+                                                 return FOCChartManager::getInstance();
                                              });
     
     // 注册电机模式控制管理器为单例
@@ -43,13 +44,26 @@ int main(int argc, char *argv[])
                                                          return new MotorModeControlManager();
                                                      });
     
+    // 注册突发捕获管理器为单例
+    qmlRegisterSingletonType<BurstCaptureManager>("FOC_CTRL", 1, 0, "BurstCaptureManager",
+                                                 [](QQmlEngine *engine, QJSEngine *scriptEngine) -> QObject * {
+                                                     Q_UNUSED(engine)
+                                                     Q_UNUSED(scriptEngine)
+                                                     return BurstCaptureManager::getInstance();
+                                                 });
+    
     // 连接串口通信管理器到图表管理器，用于接收实时数据
-    // 在C++层面直接建立信号连接，避免QML中转
-    FOCChartManager* chartManager = new FOCChartManager();
+    // 在C++层面直接建立信号连接，避免QML中转；与QML单例为同一实例
+    // 按批接收协议帧，每次取帧只触发一次处理
+    FOCChartManager* chartManager = FOCChartManager::getInstance();
+    QObject::connect(SerialCommunicationManager::getInstance(), 
+                     &SerialCommunicationManager::framesReceived,
+                     chartManager,
+                     &FOCChartManager::onFramesReceived);
     QObject::connect(SerialCommunicationManager::getInstance(), 
-                     &SerialCommunicationManager::cmdReadDataReceived,
+                     &SerialCommunicationManager::blocksReceived,
                      chartManager,
-                     &FOCChartManager::onReadDataReceived);
+                     &FOCChartManager::onBlocksReceived);
     
     QObject::connect(
         &engine,
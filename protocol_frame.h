@@ -0,0 +1,281 @@
+#ifndef PROTOCOL_FRAME_H
+#define PROTOCOL_FRAME_H
+
+#include <array>
+#include <cstdint>
+
+extern "C" {
+#include "DOC/motor_protocol.h"
+}
+
+// 固定长度协议帧：值类型，不涉及堆分配
+using ProtocolFrame = std::array<uint8_t, PROTOCOL_LENGTH>;
+
+static const int PROTOCOL_DATA_LENGTH = 10; // 数据区长度
+
+/**
+ * @brief 协议帧编码（编译期可求值）
+ *
+ * 帧格式：[包头 0xAA][命令字][数据区10字节][校验和][包尾 0x55]
+ * 校验和为包头到数据区结束的累加和低8位
+ */
+namespace ProtocolEncoder {
+
+// 通用编码：data为数据区，最多取10字节，不足补0
+constexpr ProtocolFrame encode(uint8_t cmd, const uint8_t *data = nullptr, int len = 0)
+{
+    ProtocolFrame frame{};
+    frame[0] = PROTOCOL_HEADER;
+    frame[1] = cmd;
+    for (int i = 0; i < PROTOCOL_DATA_LENGTH && i < len; ++i) {
+        frame[2 + i] = data[i];
+    }
+
+    uint16_t checksum = 0;
+    for (int i = 0; i < PROTOCOL_LENGTH - 2; ++i) {
+        checksum += frame[i];
+    }
+    frame[PROTOCOL_LENGTH - 2] = uint8_t(checksum & 0xFF);
+    frame[PROTOCOL_LENGTH - 1] = PROTOCOL_FOOTER;
+    return frame;
+}
+
+// 读数据：[2]数据ID
+constexpr ProtocolFrame encodeReadData(uint8_t dataId)
+{
+    const uint8_t data[1] = { dataId };
+    return encode(CMD_READ_DATA, data, 1);
+}
+
+// 写数据：[2]数据ID，[3..6]数据值（小端）
+constexpr ProtocolFrame encodeWriteData(uint8_t dataId, uint32_t value)
+{
+    const uint8_t data[5] = {
+        dataId,
+        uint8_t(value & 0xFF),
+        uint8_t((value >> 8) & 0xFF),
+        uint8_t((value >> 16) & 0xFF),
+        uint8_t((value >> 24) & 0xFF)
+    };
+    return encode(CMD_WRITE_DATA, data, 5);
+}
+
+// 无数据命令：启动、停止、校准、状态查询等，数据区全部填充0
+constexpr ProtocolFrame encodeCommand(motor_command_t cmd)
+{
+    return encode(uint8_t(cmd));
+}
+
+// 状态订阅请求：[2]子命令，[3..4]周期（0.1ms，小端），[5]数据ID个数，[6..11]数据ID
+constexpr ProtocolFrame encodeStatusSubscribe(status_report_op_t op, uint32_t periodUs, const uint8_t *ids, int count)
+{
+    uint32_t period = periodUs / 100;
+    if (period < 1) {
+        period = 1;
+    } else if (period > 0xFFFF) {
+        period = 0xFFFF;
+    }
+    if (count > STATUS_REPORT_IDS_PER_REQUEST) {
+        count = STATUS_REPORT_IDS_PER_REQUEST;
+    }
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {
+        uint8_t(op), uint8_t(period & 0xFF), uint8_t((period >> 8) & 0xFF), uint8_t(count)
+    };
+    for (int i = 0; i < count; ++i) {
+        data[4 + i] = ids[i];
+    }
+    return encode(CMD_STATUS_SUBSCRIBE, data, PROTOCOL_DATA_LENGTH);
+}
+
+// 完整订阅：首包为订阅（替换原订阅），超出一包的数据ID用追加包发送
+// 返回写入out的帧数；count为0时只生成取消订阅包
+inline int encodeStatusSubscription(uint32_t periodUs, const uint8_t *ids, int count, ProtocolFrame *out, int maxFrames)
+{
+    if (count <= 0) {
+        if (maxFrames < 1) {
+            return 0;
+        }
+        out[0] = encodeStatusSubscribe(STATUS_REPORT_UNSUBSCRIBE, periodUs, nullptr, 0);
+        return 1;
+    }
+    int frames = 0;
+    for (int i = 0; i < count && frames < maxFrames; i += STATUS_REPORT_IDS_PER_REQUEST) {
+        int n = count - i < STATUS_REPORT_IDS_PER_REQUEST ? count - i : STATUS_REPORT_IDS_PER_REQUEST;
+        out[frames++] = encodeStatusSubscribe(i == 0 ? STATUS_REPORT_SUBSCRIBE : STATUS_REPORT_SUBSCRIBE_APPEND,
+                                              periodUs, ids + i, n);
+    }
+    return frames;
+}
+
+// 协议版本协商：[2]请求版本，[3..4]主机可接收的最大载荷，[5..6]最长攒包时间（ms）
+constexpr ProtocolFrame encodeNegotiate(uint8_t version, uint16_t maxPayload, uint16_t maxBlockMs)
+{
+    const uint8_t data[5] = {
+        version,
+        uint8_t(maxPayload & 0xFF), uint8_t(maxPayload >> 8),
+        uint8_t(maxBlockMs & 0xFF), uint8_t(maxBlockMs >> 8)
+    };
+    return encode(CMD_PROTOCOL_NEGOTIATE, data, 5);
+}
+
+// 突发捕获配置：[2]子命令，[3..4]采样分频，[5]通道数，[6..11]数据ID
+constexpr ProtocolFrame encodeBurstConfig(uint16_t divider, const uint8_t *ids, int count)
+{
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {
+        BURST_CAPTURE_CONFIG, uint8_t(divider & 0xFF), uint8_t(divider >> 8), uint8_t(count)
+    };
+    for (int i = 0; i < count && i < BURST_CAPTURE_MAX_CHANNELS; ++i) {
+        data[4 + i] = ids[i];
+    }
+    return encode(CMD_BURST_CAPTURE, data, PROTOCOL_DATA_LENGTH);
+}
+
+// 突发捕获启动：[2]子命令，[3]触发方式，[4]触发通道，[5..8]触发电平（float），[9..10]预触发点数
+constexpr ProtocolFrame encodeBurstArm(uint8_t mode, uint8_t channel, uint32_t levelBits, uint16_t preTrigger)
+{
+    const uint8_t data[9] = {
+        BURST_CAPTURE_ARM, mode, channel,
+        uint8_t(levelBits & 0xFF), uint8_t((levelBits >> 8) & 0xFF),
+        uint8_t((levelBits >> 16) & 0xFF), uint8_t((levelBits >> 24) & 0xFF),
+        uint8_t(preTrigger & 0xFF), uint8_t(preTrigger >> 8)
+    };
+    return encode(CMD_BURST_CAPTURE, data, 9);
+}
+
+// 突发捕获分块读取：[2]子命令，[3..4]起始块号，[5..6]块数
+constexpr ProtocolFrame encodeBurstRead(uint16_t firstChunk, uint16_t count)
+{
+    const uint8_t data[5] = {
+        BURST_CAPTURE_READ,
+        uint8_t(firstChunk & 0xFF), uint8_t(firstChunk >> 8),
+        uint8_t(count & 0xFF), uint8_t(count >> 8)
+    };
+    return encode(CMD_BURST_CAPTURE, data, 5);
+}
+
+// 仅含子命令的突发捕获请求（状态查询、中止）
+constexpr ProtocolFrame encodeBurstOp(uint8_t op)
+{
+    return encode(CMD_BURST_CAPTURE, &op, 1);
+}
+
+// CRC-16/CCITT-FALSE（多项式0x1021，初值0xFFFF），与ringbuf_crc16相同
+constexpr uint16_t crc16(const uint8_t *data, int len, uint16_t crc = 0xFFFF)
+{
+    for (int i = 0; i < len; ++i) {
+        crc ^= uint16_t(data[i] << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// v2帧头校验：字节0~4累加和取反
+constexpr uint8_t v2HeaderCheck(const uint8_t *header)
+{
+    return uint8_t(~(header[0] + header[1] + header[2] + header[3] + header[4]));
+}
+
+// v2变长帧：out至少需要len+8字节，返回帧总长度
+inline int encodeV2(uint8_t cmd, uint8_t seq, const uint8_t *payload, int len, uint8_t *out)
+{
+    out[0] = PROTOCOL_V2_HEADER;
+    out[1] = cmd;
+    out[2] = seq;
+    out[3] = uint8_t(len & 0xFF);
+    out[4] = uint8_t((len >> 8) & 0xFF);
+    out[5] = v2HeaderCheck(out);
+    for (int i = 0; i < len; ++i) {
+        out[PROTOCOL_V2_HEADER_LENGTH + i] = payload[i];
+    }
+    uint16_t crc = crc16(out, PROTOCOL_V2_HEADER_LENGTH + len);
+    out[PROTOCOL_V2_HEADER_LENGTH + len] = uint8_t(crc & 0xFF);
+    out[PROTOCOL_V2_HEADER_LENGTH + len + 1] = uint8_t(crc >> 8);
+    return PROTOCOL_V2_HEADER_LENGTH + len + PROTOCOL_V2_CRC_LENGTH;
+}
+
+} // namespace ProtocolEncoder
+
+/**
+ * @brief 协议帧解码辅助
+ */
+namespace ProtocolDecoder {
+
+// 4字节小端数据值
+constexpr uint32_t readU32(const uint8_t *p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// 状态主动上报包：与订阅应答同为CMD_STATUS_SUBSCRIBE，字节2为数据ID（>=0x10）；订阅应答包字节2为子命令
+constexpr bool isStatusStream(const uint8_t *frame)
+{
+    return frame[1] == CMD_STATUS_SUBSCRIBE && frame[2] >= DATA_ID_PHASE_CURRENT_U_TARGET;
+}
+
+// 取出主动上报包中的数据（最多2个），返回个数
+inline int decodeStatusStream(const uint8_t *frame, uint8_t ids[2], uint32_t values[2])
+{
+    ids[0] = frame[2];
+    values[0] = readU32(frame + 3);
+    if (frame[7] == 0) {
+        return 1;
+    }
+    ids[1] = frame[7];
+    values[1] = readU32(frame + 8);
+    return 2;
+}
+
+// v2批量数据块：[0]通道数C，[1..C]数据ID，样本数，样本间隔（0.1ms），S×C个4字节数据值
+struct SampleBlock {
+    int channels = 0;
+    const uint8_t *ids = nullptr;
+    int samples = 0;
+    uint32_t periodUs = 0;
+    const uint8_t *values = nullptr;
+
+    // 第sample个样本中第channel个通道的数据值
+    uint32_t value(int sample, int channel) const { return readU32(values + 4 * (sample * channels + channel)); }
+};
+
+// 解析批量数据块，长度与声明不符时返回false
+inline bool decodeSampleBlock(const uint8_t *payload, int len, SampleBlock &block)
+{
+    if (len < 1) {
+        return false;
+    }
+    int channels = payload[0];
+    int headerLen = 1 + channels + 4;
+    if (channels == 0 || len < headerLen) {
+        return false;
+    }
+    const uint8_t *p = payload + 1 + channels;
+    int samples = p[0] | (p[1] << 8);
+    if (len < headerLen + samples * channels * 4) {
+        return false;
+    }
+    block.channels = channels;
+    block.ids = payload + 1;
+    block.samples = samples;
+    block.periodUs = uint32_t(p[2] | (p[3] << 8)) * 100;
+    block.values = payload + headerLen;
+    return true;
+}
+
+} // namespace ProtocolDecoder
+
+// 与协议文档中的示例帧核对
+static_assert(ProtocolEncoder::encodeReadData(0x18)[12] == 0xC4, "读数据帧校验和错误");
+static_assert(ProtocolEncoder::encodeWriteData(0x1A, 0x40200000u)[12] == 0x25, "写数据帧校验和错误");
+static_assert(ProtocolEncoder::encodeCommand(CMD_MOTOR_STOP)[12] == 0xAE, "停止命令帧校验和错误");
+static_assert(ProtocolEncoder::encodeNegotiate(2, 512, 20)[12] == 0xD2, "协议协商帧校验和错误");
+static constexpr uint8_t STATUS_SUBSCRIBE_EXAMPLE_IDS[] = { 0x17, 0x19 };
+static_assert(ProtocolEncoder::encodeStatusSubscribe(STATUS_REPORT_SUBSCRIBE, 10000, STATUS_SUBSCRIBE_EXAMPLE_IDS, 2)[12] == 0x53,
+              "订阅请求帧校验和错误");
+static constexpr uint8_t BURST_CONFIG_EXAMPLE_IDS[] = { 0x11, 0x13 };
+static_assert(ProtocolEncoder::encodeBurstConfig(2, BURST_CONFIG_EXAMPLE_IDS, 2)[12] == 0xE3, "突发捕获配置帧校验和错误");
+static constexpr uint8_t CRC16_CHECK_INPUT[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+static_assert(ProtocolEncoder::crc16(CRC16_CHECK_INPUT, 9) == 0x29B1, "CRC-16/CCITT-FALSE校验值错误");
+
+#endif // PROTOCOL_FRAME_H
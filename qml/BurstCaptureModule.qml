@@ -0,0 +1,237 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtCharts
+import FOC_CTRL 1.0 as FOC
+
+Rectangle {
+    id: burstCaptureModule
+    color: "#1E1E1E"
+    border.width: 1
+    border.color: "#464647"
+
+    // 捕获中（配置、等待触发、采集、读取）
+    property bool busy: FOC.BurstCaptureManager.state >= 1 && FOC.BurstCaptureManager.state <= 4
+
+    // 当前勾选的通道名
+    function selectedChannels() {
+        var names = []
+        for (var i = 0; i < channelRepeater.count; i++) {
+            if (channelRepeater.itemAt(i).checked) {
+                names.push(channelRepeater.itemAt(i).text)
+            }
+        }
+        return names
+    }
+
+    // 捕获完成后按通道重建曲线，整批点由C++一次替换进曲线
+    function showCapture() {
+        burstChart.removeAllSeries()
+        var names = FOC.BurstCaptureManager.channelNames
+        var colors = ["#FF5555", "#55FF55", "#5599FF", "#FFAA00", "#FF55FF", "#55FFFF"]
+        var yMin = Number.MAX_VALUE
+        var yMax = -Number.MAX_VALUE
+        for (var c = 0; c < names.length; c++) {
+            var series = burstChart.createSeries(ChartView.SeriesTypeLine, names[c], burstAxisX, burstAxisY)
+            series.color = colors[c % colors.length]
+            series.width = 1
+            FOC.BurstCaptureManager.fillSeries(series, c)
+            for (var k = 0; k < series.count; k++) {
+                var y = series.at(k).y
+                yMin = Math.min(yMin, y)
+                yMax = Math.max(yMax, y)
+            }
+        }
+        var periodMs = FOC.BurstCaptureManager.samplePeriodUs / 1000.0
+        burstAxisX.min = -FOC.BurstCaptureManager.triggerIndex * periodMs
+        burstAxisX.max = (FOC.BurstCaptureManager.sampleCount - 1 - FOC.BurstCaptureManager.triggerIndex) * periodMs
+        if (yMin <= yMax) {
+            var margin = Math.max((yMax - yMin) * 0.1, 0.1)
+            burstAxisY.min = yMin - margin
+            burstAxisY.max = yMax + margin
+        }
+    }
+
+    Connections {
+        target: FOC.BurstCaptureManager
+        function onCaptureCompleted() {
+            showCapture()
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        anchors.margins: 8
+        spacing: 5
+
+        // 标题与状态
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 10
+
+            Text {
+                text: qsTr("突发捕获")
+                color: "#FFFFFF"
+                font.pixelSize: 14
+                font.bold: true
+            }
+
+            Text {
+                text: FOC.BurstCaptureManager.stateText
+                      + (FOC.BurstCaptureManager.totalChunks > 0
+                         ? qsTr("  %1/%2块  补读%3")
+                               .arg(FOC.BurstCaptureManager.receivedChunks)
+                               .arg(FOC.BurstCaptureManager.totalChunks)
+                               .arg(FOC.BurstCaptureManager.retransmittedChunks)
+                         : "")
+                color: "#CCCCCC"
+                font.pixelSize: 12
+            }
+
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1
+                value: FOC.BurstCaptureManager.progress
+            }
+        }
+
+        // 通道选择
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 5
+
+            Repeater {
+                id: channelRepeater
+                model: FOC.BurstCaptureManager.availableChannels
+                onItemAdded: triggerChannelCombo.model = selectedChannels()
+
+                CheckBox {
+                    text: modelData
+                    checked: index < 3 // 默认三相电流
+                    enabled: !busy
+                    onCheckedChanged: triggerChannelCombo.model = selectedChannels()
+                    contentItem: Text {
+                        text: parent.text
+                        color: "#FFFFFF"
+                        font.pixelSize: 12
+                        leftPadding: parent.indicator.width + 4
+                        verticalAlignment: Text.AlignVCenter
+                    }
+                }
+            }
+        }
+
+        // 分频、触发与预触发设置
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 5
+
+            Text { text: qsTr("分频"); color: "#FFFFFF"; font.pixelSize: 12 }
+            SpinBox {
+                id: dividerSpinBox
+                from: 1
+                to: 1000
+                value: 1
+                editable: true
+                enabled: !busy
+                Layout.preferredWidth: 90
+            }
+
+            Text { text: qsTr("触发"); color: "#FFFFFF"; font.pixelSize: 12 }
+            ComboBox {
+                id: triggerModeCombo
+                model: [qsTr("立即"), qsTr("上升沿"), qsTr("下降沿")]
+                enabled: !busy
+                Layout.preferredWidth: 90
+            }
+
+            ComboBox {
+                id: triggerChannelCombo
+                enabled: !busy && triggerModeCombo.currentIndex > 0
+                Layout.preferredWidth: 100
+            }
+
+            Text { text: qsTr("电平"); color: "#FFFFFF"; font.pixelSize: 12 }
+            TextField {
+                id: triggerLevelField
+                text: "0"
+                enabled: !busy && triggerModeCombo.currentIndex > 0
+                validator: DoubleValidator {}
+                Layout.preferredWidth: 60
+            }
+
+            Text { text: qsTr("预触发%"); color: "#FFFFFF"; font.pixelSize: 12 }
+            SpinBox {
+                id: preTriggerSpinBox
+                from: 0
+                to: 100
+                value: 20
+                editable: true
+                enabled: !busy
+                Layout.preferredWidth: 90
+            }
+
+            Item { Layout.fillWidth: true }
+
+            Button {
+                id: captureButton
+                text: busy ? qsTr("中止") : qsTr("捕获")
+                Layout.preferredWidth: 70
+                Layout.preferredHeight: 30
+
+                background: Rectangle {
+                    color: busy ? "#AA3333" : (captureButton.pressed ? "#1066CC" : "#0E639C")
+                    radius: 3
+                    border.width: 1
+                    border.color: "#464647"
+                }
+
+                contentItem: Text {
+                    text: captureButton.text
+                    color: "#FFFFFF"
+                    font.pixelSize: 12
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+
+                onClicked: {
+                    if (busy) {
+                        FOC.BurstCaptureManager.abortCapture()
+                        return
+                    }
+                    var channels = selectedChannels()
+                    var triggerChannel = Math.max(0, channels.indexOf(triggerChannelCombo.currentText))
+                    FOC.BurstCaptureManager.startCapture(channels, dividerSpinBox.value, triggerModeCombo.currentIndex,
+                                                         triggerChannel, Number(triggerLevelField.text),
+                                                         preTriggerSpinBox.value)
+                }
+            }
+        }
+
+        // 捕获波形（横轴为相对触发点的时间）
+        ChartView {
+            id: burstChart
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            antialiasing: true
+            legend.visible: true
+
+            ValueAxis {
+                id: burstAxisX
+                min: -1
+                max: 10
+                titleText: qsTr("相对触发点时间 (ms)")
+                labelFormat: "%.2f"
+            }
+
+            ValueAxis {
+                id: burstAxisY
+                min: -10
+                max: 10
+                titleText: qsTr("值")
+                labelFormat: "%.2f"
+            }
+        }
+    }
+}
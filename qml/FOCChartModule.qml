@@ -51,6 +51,9 @@ Rectangle {
             series: newSeries
         });
         
+        // 曲线的点由C++按显示帧整体刷新
+        FOC.FOCChartManager.attachSeries(varName, newSeries);
+        
         console.log("添加变量后变量列表长度:", variableList.length);
         
         // 更新变量列表显示
@@ -151,39 +154,23 @@ Rectangle {
         })
     }
     
-    // 实际数据接收器 - 从C++后端获取转速数据
+    // 曲线最新数据点的时间（毫秒，相对C++端的时间原点）
     property real timeCounter: 0
     
-    // 主动读取定时器 - 10ms读取一次变量值
-    Timer {
-        id: variableReadTimer
-        interval: 10  // 10ms读取一次
+    // 曲线刷新 - 每个显示帧一次，由C++按当前可见窗口切出各曲线的点并整体替换
+    FrameAnimation {
+        id: seriesRefreshAnimation
         running: isCollecting  // 只在采集状态下运行
-        repeat: true
         onTriggered: {
-            // 为每个变量读取当前值并更新曲线
-            for (var i = 0; i < variableList.length; i++) {
-                var variableName = variableList[i].name
-                var currentValue = FOC.FOCChartManager.getVariableValue(variableName)
-                
-                // 时间计数器递增（以毫秒为单位，与X轴一致）
-                timeCounter += 10  // 10ms，对应100Hz的更新频率
-                
-                // 处理数据，添加到对应的曲线系列
-                variableList[i].series.append(timeCounter, currentValue)
-                
-                // 限制数据点数量，避免内存溢出（保留20000ms的数据）
-                if (variableList[i].series.count > 2000) {  // 20000ms / 10ms = 2000个点
-                    variableList[i].series.remove(0)
-                }
-                
-                // 自动调整X轴范围（以毫秒为单位）
-                if (timeCounter > axisX.max) {
-                    axisX.max = timeCounter
-                    axisX.min = Math.max(0, timeCounter - 20000)  // 显示最近20000ms的数据
-                }
-                
-                // 调试信息已移除，避免控制台输出过多信息
+            var latest = FOC.FOCChartManager.refreshSeries(axisX.min, axisX.max, chartView.plotArea.width)
+            if (latest > timeCounter) {
+                timeCounter = latest
+            }
+            
+            // 自动调整X轴范围（以毫秒为单位），新窗口的点在下一帧切出
+            if (timeCounter > axisX.max) {
+                axisX.max = timeCounter
+                axisX.min = Math.max(0, timeCounter - 20000)  // 显示最近20000ms的数据
             }
         }
     }
@@ -193,12 +180,30 @@ Rectangle {
         spacing: 5
         anchors.margins: 10
 
-        Text {
-            id: chartTitleText
-            text: qsTr("FOC数据曲线显示")
-            color: "#FFFFFF"
-            font.pixelSize: 16
-            font.bold: true
+        RowLayout {
+            Layout.fillWidth: true
+
+            Text {
+                id: chartTitleText
+                text: qsTr("FOC数据曲线显示")
+                color: "#FFFFFF"
+                font.pixelSize: 16
+                font.bold: true
+            }
+
+            Item { Layout.fillWidth: true }
+
+            // 每帧曲线刷新耗时（平均/最大）与样本存储占用
+            Text {
+                text: qsTr("曲线刷新 %1 / %2 us  存储 %3 MB（每变量上限 %4 MB）")
+                      .arg(FOC.FOCChartManager.seriesUpdateUs.toFixed(0))
+                      .arg(FOC.FOCChartManager.seriesUpdateMaxUs.toFixed(0))
+                      .arg((FOC.FOCChartManager.sampleMemoryBytes / 1048576).toFixed(1))
+                      .arg((FOC.FOCChartManager.channelMemoryLimitBytes / 1048576).toFixed(1))
+                color: "#CCCCCC"
+                font.pixelSize: 12
+                visible: isCollecting
+            }
         }
 
         // 变量列表区域
@@ -234,6 +239,9 @@ Rectangle {
                 anchors.fill: parent
                 antialiasing: true
                 
+                // 绘图区宽度决定抽点的像素列数，停止采集后改变窗口大小时重新抽点
+                onPlotAreaChanged: if (!isCollecting) FOC.FOCChartManager.refreshSeries(axisX.min, axisX.max, plotArea.width)
+                
                 // X轴
                 ValueAxis {
                     id: axisX
@@ -241,6 +249,10 @@ Rectangle {
                     max: 20000  // 改为毫秒为单位，显示20000ms范围
                     titleText: qsTr("时间 (ms)")
                     labelFormat: "%.0f"
+                    
+                    // 停止采集后缩放/拖动时按新窗口重新切片（采集中由每帧刷新处理）
+                    onMinChanged: if (!isCollecting) FOC.FOCChartManager.refreshSeries(min, max, chartView.plotArea.width)
+                    onMaxChanged: if (!isCollecting) FOC.FOCChartManager.refreshSeries(min, max, chartView.plotArea.width)
                 }
                 
                 // Y轴
@@ -537,6 +549,24 @@ Rectangle {
             }
         }
 
+            Button {
+                // 采集方式：周期读取 / 状态订阅（电机主动上报）
+                text: qsTr("主动上报")
+                Layout.fillWidth: true
+                checkable: true
+                checked: FOC.FOCChartManager.streamingMode
+                background: Rectangle {
+                    color: parent.checked ? "#2196F3" : "#3C3C3C"
+                }
+                contentItem: Text {
+                    text: parent.checked ? qsTr("主动上报") : qsTr("周期读取")
+                    color: "#FFFFFF"
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+                onToggled: FOC.FOCChartManager.streamingMode = checked
+            }
+
             Button {
                 text: qsTr("清除变量")
                 Layout.fillWidth: true
@@ -587,7 +617,9 @@ Rectangle {
                             series.clear()
                         }
                     }
-                    dataTimer.timeCounter = 0
+                    // 丢弃C++中已存的样本，时间轴从零重新开始
+                    FOC.FOCChartManager.clearSamples()
+                    timeCounter = 0
                     axisX.min = 0
                     axisX.max = 20000
                     axisY.min = -1200
@@ -202,25 +202,43 @@ Rectangle {
             border.width: 1
             border.color: "#464647"
             
-            TextArea {
+            // 收发记录：列表只为可见行创建委托，记录增删不再重建整段文本
+            ListView {
                 id: dataDisplayArea
                 anchors.fill: parent
                 anchors.margins: 5
-                text: SerialCommManager ? SerialCommManager.displayData : ""
-                readOnly: true
-                font.family: "Consolas, Monaco, monospace"
-                font.pixelSize: 12
-                color: "#FFFFFF"
-                background: Rectangle {
-                    color: "transparent"
+                model: SerialCommManager ? SerialCommManager.trafficLog : null
+                clip: true
+                reuseItems: true
+                boundsBehavior: Flickable.StopAtBounds
+
+                // 停在底部时跟随新记录，向上翻看时保持不动
+                // （写满后每帧淘汰与插入条数相同，count不变，所以跟随rowsInserted）
+                property bool followTail: true
+                onMovementEnded: followTail = atYEnd
+                Connections {
+                    target: dataDisplayArea.model
+                    function onRowsInserted() {
+                        if (dataDisplayArea.followTail) {
+                            dataDisplayArea.positionViewAtEnd()
+                        }
+                    }
+                    function onModelReset() {
+                        dataDisplayArea.followTail = true
+                    }
+                }
+
+                delegate: Text {
+                    width: ListView.view.width
+                    text: model.display
+                    color: "#FFFFFF"
+                    font.family: "Consolas, Monaco, monospace"
+                    font.pixelSize: 12
+                    wrapMode: Text.WrapAnywhere  // 允许在任意字符处换行
                 }
-                wrapMode: TextEdit.WrapAnywhere  // 允许在任意字符处换行
-                // 自动滚动到底部
-                onTextChanged: {
-                    // 使用更可靠的滚动方式
-                    dataDisplayArea.selectAll()
-                    dataDisplayArea.cursorPosition = dataDisplayArea.length
-                    dataDisplayArea.deselect()
+
+                ScrollBar.vertical: ScrollBar {
+                    policy: ScrollBar.AsNeeded
                 }
             }
         }
@@ -380,6 +398,77 @@ Rectangle {
             
             Item { Layout.fillWidth: true } // 弹簧
             
+            // 会话录制：全部收发原始数据写入文件（文档目录/FOC_Recordings）
+            Text {
+                visible: serialManager ? serialManager.isRecording : false
+                text: "已录制 " + (serialManager ? formatBytes(serialManager.recordedBytes) : "0 B")
+                      + (serialManager && serialManager.recordingDroppedBytes > 0
+                         ? "（丢弃 " + formatBytes(serialManager.recordingDroppedBytes) + "）" : "")
+                color: serialManager && serialManager.recordingDroppedBytes > 0 ? "#FF4444" : "#CCCCCC"
+                font.pixelSize: 11
+            }
+            
+            Button {
+                id: recordButton
+                text: serialManager && serialManager.isRecording ? "停止录制" : "录制"
+                width: 64
+                height: 24
+                background: Rectangle {
+                    color: recordButton.pressed ? "#A01818" : (serialManager && serialManager.isRecording ? "#C42B1C" : (recordButton.hovered ? "#1177DD" : "#0E639C"))
+                    radius: 3
+                    border.width: 1
+                    border.color: "#464647"
+                }
+                contentItem: Text {
+                    text: recordButton.text
+                    color: "#FFFFFF"
+                    font.pixelSize: 11
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+                onClicked: {
+                    if (serialManager) {
+                        if (serialManager.isRecording) {
+                            serialManager.stopRecording()
+                        } else {
+                            serialManager.startRecording()
+                        }
+                    }
+                }
+            }
+            
+            // 会话回放：回放最近一次录制的文件，代替串口送入接收数据
+            Button {
+                id: replayButton
+                text: serialManager && serialManager.isReplaying ? "停止回放" : "回放"
+                width: 64
+                height: 24
+                enabled: serialManager ? (serialManager.isReplaying
+                                          || (serialManager.recordingPath !== "" && !serialManager.isRecording)) : false
+                background: Rectangle {
+                    color: replayButton.pressed ? "#1066CC" : (replayButton.hovered ? "#1177DD" : (replayButton.enabled ? "#0E639C" : "#3C3C3C"))
+                    radius: 3
+                    border.width: 1
+                    border.color: "#464647"
+                }
+                contentItem: Text {
+                    text: replayButton.text
+                    color: "#FFFFFF"
+                    font.pixelSize: 11
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+                onClicked: {
+                    if (serialManager) {
+                        if (serialManager.isReplaying) {
+                            serialManager.disconnectPort()
+                        } else {
+                            serialManager.startReplay(serialManager.recordingPath, serialManager.replaySpeed)
+                        }
+                    }
+                }
+            }
+            
             Button {
                 id: clearButton
                 text: "清空"
@@ -407,5 +496,51 @@ Rectangle {
             }
     
         }
+
+        // 回放控制：速度、定位与吞吐（尽快回放时即整条接收链路的吞吐）
+        RowLayout {
+            visible: serialManager ? serialManager.isReplaying : false
+            Layout.fillWidth: true
+            Layout.maximumWidth: parent.width
+            spacing: 10
+
+            ComboBox {
+                id: replaySpeedComboBox
+                property var speeds: [1, 10, 100, 0]
+                model: ["1×", "10×", "100×", "最快"]
+                currentIndex: serialManager ? Math.max(0, speeds.indexOf(serialManager.replaySpeed)) : 0
+                Layout.preferredWidth: 80
+                Layout.preferredHeight: 24
+                onActivated: function(index) {
+                    if (serialManager) serialManager.replaySpeed = speeds[index]
+                }
+            }
+
+            Slider {
+                id: replaySlider
+                Layout.fillWidth: true
+                from: 0
+                to: serialManager ? Math.max(serialManager.replayDurationSec, 0.001) : 1
+                onMoved: if (serialManager) serialManager.seekReplay(value)
+
+                // 拖动时不跟随回放位置
+                Binding on value {
+                    when: !replaySlider.pressed
+                    value: serialManager ? serialManager.replayPositionSec : 0
+                    restoreMode: Binding.RestoreNone
+                }
+            }
+
+            Text {
+                text: serialManager
+                      ? serialManager.replayPositionSec.toFixed(1) + " / " + serialManager.replayDurationSec.toFixed(1) + " s"
+                        + (serialManager.replayFinished ? "（已放完）" : "")
+                        + "  " + formatBytes(Math.round(serialManager.replayBytesPerSecond)) + "/s"
+                        + "  " + Math.round(serialManager.replayFramesPerSecond) + " 帧/s"
+                      : ""
+                color: "#CCCCCC"
+                font.pixelSize: 11
+            }
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "replay_device.h"
+#include "serial_io_worker.h" // monotonicNowNs
+#include "protocol_frame.h"   // crc16
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+using namespace SessionFormat;
+
+ReplayDevice::ReplayDevice(QObject *parent)
+    : QIODevice(parent)
+    , m_timer(new QTimer(this))
+    , m_chunkHeaderBytes(int(sizeof(ChunkHeader)))
+    , m_recordHeaderBytes(RECORD_HEADER_BYTES)
+    , m_baudRate(0)
+    , m_chunkIndex(0)
+    , m_chunkPos(0)
+    , m_hasRecord(false)
+    , m_recNs(0)
+    , m_recIsTx(false)
+    , m_recOffset(0)
+    , m_recLen(0)
+    , m_speed(1.0)
+    , m_recBaseNs(0)
+    , m_wallBaseNs(0)
+    , m_presentRecBaseNs(0)
+    , m_presentBaseNs(0)
+    , m_lastPresentedNs(0)
+    , m_markHead(0)
+    , m_bytesRead(0)
+    , m_durationNs(0)
+    , m_positionNs(0)
+    , m_bytesReplayed(0)
+    , m_finished(false)
+    , m_badChunks(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ReplayDevice::onTick);
+}
+
+bool ReplayDevice::open(OpenMode mode)
+{
+    m_timer->stop();
+    m_file.close();
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setErrorString(QString("无法打开回放文件: %1").arg(m_file.errorString()));
+        return false;
+    }
+    m_badChunks.store(0, std::memory_order_relaxed);
+    if (!buildIndex()) {
+        m_file.close();
+        return false;
+    }
+
+    m_pending.clear();
+    m_marks.clear();
+    m_markHead = 0;
+    m_bytesRead = 0;
+    m_bytesReplayed.store(0, std::memory_order_relaxed);
+    m_positionNs.store(0, std::memory_order_relaxed);
+
+    loadChunk(0);
+    nextRecord();
+    m_finished.store(!m_hasRecord, std::memory_order_relaxed);
+
+    // 第一条记录对齐到当前时刻送出
+    qint64 now = monotonicNowNs();
+    m_presentBaseNs = now;
+    m_presentRecBaseNs = m_hasRecord ? m_recNs : 0;
+    m_lastPresentedNs = now;
+    rebaseClock(now);
+
+    // 不经QIODevice内部缓冲：readData()读出的字节即调用方拿到的字节，bytesRead()与接收数据流一一对应
+    if (!QIODevice::open(mode | QIODevice::Unbuffered)) {
+        m_file.close();
+        return false;
+    }
+    scheduleNext(now);
+    return true;
+}
+
+void ReplayDevice::close()
+{
+    m_timer->stop();
+    m_file.close();
+    m_pending.clear();
+    m_marks.clear();
+    m_markHead = 0;
+    m_chunk = QByteArray();
+    m_hasRecord = false;
+    QIODevice::close();
+}
+
+qint64 ReplayDevice::bytesAvailable() const
+{
+    return m_pending.size() + QIODevice::bytesAvailable();
+}
+
+qint64 ReplayDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 n = qMin<qint64>(maxSize, m_pending.size());
+    if (n <= 0) {
+        return 0;
+    }
+    memcpy(data, m_pending.constData(), size_t(n));
+    m_pending.remove(0, int(n));
+    m_bytesRead += n;
+    return n;
+}
+
+qint64 ReplayDevice::writeData(const char *data, qint64 len)
+{
+    // 回放时没有电机应答，主机发出的命令直接丢弃
+    Q_UNUSED(data);
+    return len;
+}
+
+bool ReplayDevice::buildIndex()
+{
+    m_index.clear();
+
+    FileHeader header;
+    if (m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) != 0) {
+        setErrorString("不是会话录制文件");
+        return false;
+    }
+    if (header.version != VERSION
+        || header.chunkHeaderBytes < sizeof(ChunkHeader)
+        || header.recordHeaderBytes < RECORD_HEADER_BYTES) {
+        setErrorString(QString("不支持的录制文件版本: %1").arg(header.version));
+        return false;
+    }
+    m_chunkHeaderBytes = header.chunkHeaderBytes;
+    m_recordHeaderBytes = header.recordHeaderBytes;
+    m_baudRate = int(header.baudRate);
+
+    // 只读块头、按载荷长度跳到下一块：打开大文件不必读全部数据
+    qint64 size = m_file.size();
+    qint64 pos = header.fileHeaderBytes;
+    qint64 lastNs = 0;
+    while (pos + m_chunkHeaderBytes <= size) {
+        ChunkHeader chunk;
+        if (!m_file.seek(pos)
+            || m_file.read(reinterpret_cast<char*>(&chunk), sizeof(chunk)) != qint64(sizeof(chunk))
+            || chunk.magic != CHUNK_MAGIC) {
+            break; // 写入中途崩溃留下的残块
+        }
+        qint64 available = size - pos - m_chunkHeaderBytes;
+        IndexEntry entry;
+        entry.fileOffset = pos;
+        entry.payloadBytes = qMin<qint64>(chunk.payloadBytes, available);
+        entry.firstNs = chunk.firstNs;
+        entry.crc = chunk.crc;
+        entry.complete = chunk.payloadBytes <= available;
+        if (chunk.recordCount > 0) {
+            m_index.append(entry);
+            // 末块被截断时末记录时刻未知，时长只算到其首记录
+            lastNs = entry.complete ? chunk.lastNs : chunk.firstNs;
+        }
+        pos += m_chunkHeaderBytes + qint64(chunk.payloadBytes);
+    }
+
+    if (m_index.isEmpty()) {
+        setErrorString("录制文件中没有数据");
+        return false;
+    }
+    m_durationNs.store(qMax<qint64>(0, lastNs - m_index.first().firstNs), std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplayDevice::loadChunk(int index)
+{
+    for (; index < m_index.size(); ++index) {
+        const IndexEntry &entry = m_index[index];
+        m_chunk.resize(int(entry.payloadBytes));
+        if (!m_file.seek(entry.fileOffset + m_chunkHeaderBytes)
+            || m_file.read(m_chunk.data(), entry.payloadBytes) != entry.payloadBytes) {
+            continue;
+        }
+        if (entry.complete
+            && ProtocolEncoder::crc16(reinterpret_cast<const uint8_t*>(m_chunk.constData()), int(m_chunk.size())) != entry.crc) {
+            // 块内数据损坏：整块跳过，从下一块继续
+            m_badChunks.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        m_chunkIndex = index;
+        m_chunkPos = 0;
+        return true;
+    }
+    m_chunkIndex = int(m_index.size());
+    m_chunk.clear();
+    m_chunkPos = 0;
+    return false;
+}
+
+bool ReplayDevice::nextRecord()
+{
+    for (;;) {
+        if (m_chunkPos + m_recordHeaderBytes <= m_chunk.size()) {
+            const char *p = m_chunk.constData() + m_chunkPos;
+            int64_t ns;
+            uint32_t lengthAndDir;
+            memcpy(&ns, p, sizeof(ns));
+            memcpy(&lengthAndDir, p + sizeof(ns), sizeof(lengthAndDir));
+            int len = int(lengthAndDir & ~TX_FLAG);
+            int dataPos = m_chunkPos + m_recordHeaderBytes;
+            if (len <= m_chunk.size() - dataPos) {
+                m_recNs = ns;
+                m_recIsTx = (lengthAndDir & TX_FLAG) != 0;
+                m_recOffset = dataPos;
+                m_recLen = len;
+                m_chunkPos = dataPos + len;
+                m_hasRecord = true;
+                return true;
+            }
+        }
+        // 本块已读完（截断的末块读到数据不足为止）
+        if (!loadChunk(m_chunkIndex + 1)) {
+            m_hasRecord = false;
+            return false;
+        }
+    }
+}
+
+void ReplayDevice::rebaseClock(qint64 now)
+{
+    m_wallBaseNs = now;
+    m_recBaseNs = m_hasRecord ? m_recNs : 0;
+}
+
+void ReplayDevice::scheduleNext(qint64 now)
+{
+    if (!m_hasRecord) {
+        return;
+    }
+    if (m_speed <= 0.0) {
+        m_timer->start(0);
+        return;
+    }
+    qint64 waitNs = dueNs(m_recNs) - now;
+    m_timer->start(int(qBound<qint64>(0, (waitNs + 999999) / 1000000, INT_MAX)));
+}
+
+void ReplayDevice::onTick()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    qint64 now = monotonicNowNs();
+    bool fast = m_speed <= 0.0;
+    if (fast && m_readyCheck && !m_readyCheck()) {
+        m_timer->start(1); // GUI取帧跟不上：暂缓送数，回放速度即为整条链路的吞吐
+        return;
+    }
+
+    dropMarksBefore(m_bytesRead - MARK_KEEP_BYTES);
+
+    // 送出所有已到时刻的记录（尽快回放时送满一批）
+    int sent = 0;
+    qint64 firstNs = m_index.first().firstNs;
+    while (m_hasRecord && (fast ? sent < FAST_BATCH_BYTES : dueNs(m_recNs) <= now)) {
+        if (!m_recIsTx && m_recLen > 0) {
+            m_pending.append(m_chunk.constData() + m_recOffset, m_recLen);
+            sent += m_recLen;
+            qint64 end = m_bytesReplayed.load(std::memory_order_relaxed) + m_recLen;
+            m_bytesReplayed.store(end, std::memory_order_relaxed);
+            m_lastPresentedNs = qMax(m_lastPresentedNs, m_presentBaseNs + (m_recNs - m_presentRecBaseNs));
+            m_marks.append({ end, m_lastPresentedNs });
+        }
+        m_positionNs.store(m_recNs - firstNs, std::memory_order_relaxed);
+        nextRecord();
+    }
+    if (!m_hasRecord) {
+        m_finished.store(true, std::memory_order_relaxed);
+    }
+
+    if (!m_pending.isEmpty()) {
+        emit readyRead();
+    }
+    scheduleNext(now);
+}
+
+void ReplayDevice::setSpeed(double speed)
+{
+    m_speed = speed;
+    if (!isOpen()) {
+        return;
+    }
+    qint64 now = monotonicNowNs();
+    rebaseClock(now);
+    m_timer->stop();
+    scheduleNext(now);
+}
+
+void ReplayDevice::seekTime(qint64 offsetNs)
+{
+    if (!isOpen() || m_index.isEmpty()) {
+        return;
+    }
+
+    // 稀疏索引二分：首记录时刻不晚于目标的最后一块，再在块内逐条前进
+    qint64 target = m_index.first().firstNs + qMax<qint64>(0, offsetNs);
+    auto it = std::upper_bound(m_index.cbegin(), m_index.cend(), target,
+                               [](qint64 ns, const IndexEntry &entry) { return ns < entry.firstNs; });
+    int chunk = qMax(0, int(it - m_index.cbegin()) - 1);
+    loadChunk(chunk);
+    nextRecord();
+    while (m_hasRecord && m_recNs < target) {
+        nextRecord();
+    }
+    m_finished.store(!m_hasRecord, std::memory_order_relaxed);
+
+    // 未读出的数据属于定位前的位置，丢弃；数据流偏移接着已读出的字节数继续
+    m_pending.clear();
+    m_marks.clear();
+    m_markHead = 0;
+    m_bytesReplayed.store(m_bytesRead, std::memory_order_relaxed);
+
+    // 送出时刻从上一次送出的时刻之后接着排，保持单调
+    qint64 recNs = m_hasRecord ? m_recNs : target;
+    m_presentBaseNs = m_lastPresentedNs + 1000000;
+    m_presentRecBaseNs = recNs;
+    m_positionNs.store(recNs - m_index.first().firstNs, std::memory_order_relaxed);
+
+    qint64 now = monotonicNowNs();
+    rebaseClock(now);
+    m_timer->stop();
+    scheduleNext(now);
+}
+
+void ReplayDevice::dropMarksBefore(qint64 offset)
+{
+    while (m_markHead < m_marks.size() && m_marks[m_markHead].endOffset < offset) {
+        ++m_markHead;
+    }
+    // 已越过的边界过半时整体前移一次
+    if (m_markHead > 4096 && m_markHead * 2 > m_marks.size()) {
+        m_marks.remove(0, m_markHead);
+        m_markHead = 0;
+    }
+}
+
+qint64 ReplayDevice::timeAtOffset(qint64 offset)
+{
+    dropMarksBefore(offset);
+    return m_markHead < m_marks.size() ? m_marks[m_markHead].ns : m_lastPresentedNs;
+}
@@ -0,0 +1,145 @@
+#ifndef REPLAY_DEVICE_H
+#define REPLAY_DEVICE_H
+
+#include <QIODevice>
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include "session_recorder.h" // SessionFormat
+
+/**
+ * @brief 会话回放 - 把SessionRecorder录下的接收数据按原时间间隔重新送给SerialIoWorker
+ *
+ * 端口名为PORT_PREFIX加文件路径时由SerialIoWorker代替QSerialPort打开，运行在I/O线程中，
+ * 数据经readyRead/read进入与真实串口相同的接收、解包、分发、曲线路径。
+ * - 速度：1为实时，N为N倍速，小于等于0为尽快回放（每批FAST_BATCH_BYTES，GUI取帧跟不上时暂停送数）
+ * - 录制的发送记录不回放；回放期间主机写入的数据直接丢弃
+ * - 各块块头的首记录时刻就是稀疏时间索引：打开时只读块头建立索引，定位时二分查找所在块
+ * - 送出的每条记录保留录制时的时间间隔（timeAtOffset），与回放速度无关，曲线时间轴与录制时一致
+ */
+class ReplayDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *PORT_PREFIX = "REPLAY:";
+    static constexpr int FAST_BATCH_BYTES = 16 * 1024; // 尽快回放时每次送出的字节数
+    static constexpr qint64 MARK_KEEP_BYTES = 1024 * 1024; // 已读出的记录边界最多保留多少字节（远大于接收缓冲区）
+
+    explicit ReplayDevice(QObject *parent = nullptr);
+
+    void setFileName(const QString &path) { m_file.setFileName(path); }
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+    // 回放速度（I/O线程调用，从当前位置起按新速度计时）
+    void setSpeed(double speed);
+    double speed() const { return m_speed; }
+
+    // 定位到相对录制开始offsetNs处（I/O线程调用），已读出未解析的数据由调用方丢弃
+    void seekTime(qint64 offsetNs);
+
+    // 尽快回放时的背压：返回false时暂缓送数
+    void setReadyCheck(std::function<bool()> check) { m_readyCheck = std::move(check); }
+
+    /**
+     * @brief 接收数据流中第offset字节（自打开起累计read()读出的字节数）到达的时刻
+     *
+     * 时刻按录制时的间隔排列在单调时钟上：打开时对齐到当前时刻，定位后从上一次送出的时刻接着排，
+     * 所以始终不减。offset须单调不减（已越过的记录随之丢弃）。
+     */
+    qint64 timeAtOffset(qint64 offset);
+
+    // 自打开起累计read()读出的字节数（I/O线程）
+    qint64 bytesRead() const { return m_bytesRead; }
+
+    // 录制时的波特率（文件头，未知为0）
+    int baudRate() const { return m_baudRate; }
+
+    // 以下任意线程可读：录制时长、当前位置（相对录制开始）、累计送出的字节数、是否已放完、CRC错误块数
+    qint64 durationNs() const { return m_durationNs.load(std::memory_order_relaxed); }
+    qint64 positionNs() const { return m_positionNs.load(std::memory_order_relaxed); }
+    qint64 bytesReplayed() const { return m_bytesReplayed.load(std::memory_order_relaxed); }
+    bool finished() const { return m_finished.load(std::memory_order_relaxed); }
+    int badChunks() const { return m_badChunks.load(std::memory_order_relaxed); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private slots:
+    void onTick();
+
+private:
+    // 稀疏时间索引：每块一项
+    struct IndexEntry {
+        qint64 fileOffset;   // 块头在文件中的位置
+        qint64 payloadBytes; // 载荷字节数（末块被截断时为实际可读的字节数）
+        qint64 firstNs;      // 块内首记录时刻
+        uint16_t crc;        // 块头中的载荷CRC
+        bool complete;       // 块完整（载荷做CRC校验）
+    };
+
+    // 数据流中一条已送出记录的末尾位置与其时刻
+    struct Mark {
+        qint64 endOffset;
+        qint64 ns;
+    };
+
+    bool buildIndex();
+    bool loadChunk(int index);  // 读入第index块，当前记录指向块内第一条
+    bool nextRecord();          // 前进到下一条记录（必要时读入下一块），没有更多记录时返回false
+    void rebaseClock(qint64 now);
+    qint64 dueNs(qint64 recNs) const { return m_wallBaseNs + qint64(double(recNs - m_recBaseNs) / m_speed); }
+    void scheduleNext(qint64 now);
+    void dropMarksBefore(qint64 offset);
+
+    QFile m_file;
+    QTimer *m_timer;
+    std::function<bool()> m_readyCheck;
+
+    // 文件头与索引
+    int m_chunkHeaderBytes;
+    int m_recordHeaderBytes;
+    int m_baudRate;
+    QVector<IndexEntry> m_index;
+
+    // 当前块与当前记录
+    int m_chunkIndex;
+    QByteArray m_chunk;
+    int m_chunkPos;             // 下一条记录在m_chunk中的位置
+    bool m_hasRecord;
+    qint64 m_recNs;
+    bool m_recIsTx;
+    int m_recOffset;            // 当前记录数据在m_chunk中的位置
+    int m_recLen;
+
+    // 回放计时：录制时刻m_recBaseNs对应单调时钟m_wallBaseNs，按m_speed缩放
+    double m_speed;
+    qint64 m_recBaseNs;
+    qint64 m_wallBaseNs;
+
+    // 送出数据的时刻：录制时刻m_presentRecBaseNs对应单调时钟m_presentBaseNs（不随速度缩放）
+    qint64 m_presentRecBaseNs;
+    qint64 m_presentBaseNs;
+    qint64 m_lastPresentedNs;
+
+    QByteArray m_pending;       // 已送出、待read()读取的接收数据
+    QVector<Mark> m_marks;      // m_pending及之前已读出未解析数据的记录边界
+    int m_markHead;
+    qint64 m_bytesRead;
+
+    std::atomic<qint64> m_durationNs;
+    std::atomic<qint64> m_positionNs;
+    std::atomic<qint64> m_bytesReplayed;
+    std::atomic<bool> m_finished;
+    std::atomic<int> m_badChunks;
+};
+
+#endif // REPLAY_DEVICE_H
@@ -1,17 +1,50 @@
 #include "ringbuf.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
 #define min(a, b) ((a) < (b) ? (a) : (b))
+
+/*
+ * 读写指针的原子访问
+ * - 写端读取out、读端读取in使用acquire，保证看到对端已完成的数据读写
+ * - 写端更新in、读端更新out使用release，保证数据先于指针可见
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define rb_load_acquire(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define rb_load_relaxed(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define rb_store_release(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define rb_store_relaxed(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+// MSVC在x86/x64上（默认/volatile:ms）的volatile读写具有acquire/release语义
+#define rb_load_acquire(p)      (*(volatile uint32_t *)(p))
+#define rb_load_relaxed(p)      (*(volatile uint32_t *)(p))
+#define rb_store_release(p, v)  (*(volatile uint32_t *)(p) = (v))
+#define rb_store_relaxed(p, v)  (*(volatile uint32_t *)(p) = (v))
+#else
+#error "ringbuf: 不支持的编译器，需要提供原子读写实现"
+#endif
+
 // 辅助函数：检查是否为2的幂
-static uint8_t is_power_of_two(uint16_t size)
+static uint8_t is_power_of_two(uint32_t size)
 {
     return (size != 0) && ((size & (size - 1)) == 0);
 }
 
-ringbuf_t *ringbuf_alloc(uint16_t size)
+// 写端：更新高水位
+static void update_high_water(ringbuf_t *rb, uint32_t used)
+{
+    if (used > rb_load_relaxed(&rb->high_water)) {
+        rb_store_relaxed(&rb->high_water, used);
+    }
+}
+
+ringbuf_t *ringbuf_alloc(uint32_t size)
 {
-    // 检查size是否为2的幂且不为0
-    if (size == 0 || !is_power_of_two(size)) {
+    // 检查size是否为2的幂且不为0，最大2GB
+    if (size == 0 || !is_power_of_two(size) || size > 0x80000000u) {
         return NULL;
     }
 
@@ -19,6 +52,7 @@ ringbuf_t *ringbuf_alloc(uint16_t size)
     if (!rb) {
         return NULL;
     }
+    memset(rb, 0, sizeof(ringbuf_t));
 
     rb->buffer = (uint8_t *)malloc(size);
     if (!rb->buffer) {
@@ -29,14 +63,8 @@ ringbuf_t *ringbuf_alloc(uint16_t size)
     rb->size = size;
     rb->in = 0;
     rb->out = 0;
-
-#ifdef ringbuf_USE_MUTEX
-    if (mutex_init(&rb->lock) != 0) {
-        free(rb->buffer);
-        free(rb);
-        return NULL;
-    }
-#endif
+    rb->dropped = 0;
+    rb->high_water = 0;
 
     return rb;
 }
@@ -47,47 +75,44 @@ void ringbuf_free(ringbuf_t *rb)
         if (rb->buffer) {
             free(rb->buffer);
         }
-        
-#ifdef ringbuf_USE_MUTEX
-        mutex_destroy(&rb->lock);
-#endif
-        
+
         free(rb);
     }
 }
 
-uint16_t ringbuf_push(ringbuf_t *rb, const uint8_t *from, uint16_t len)
+/**
+ * @brief 写入数据（写端）
+ * @return 实际写入的长度，缓冲区空间不足时多余部分被丢弃并计入dropped
+ */
+uint32_t ringbuf_push(ringbuf_t *rb, const uint8_t *from, uint32_t len)
 {
-#ifdef ringbuf_USE_MUTEX
-    mutex_lock(&rb->lock);
-#endif
-    len = min(len, rb->size - rb->in + rb->out);
-    uint16_t l = min(len, rb->size - (rb->in & (rb->size - 1)));
-    memcpy(rb->buffer + (rb->in & (rb->size - 1)), from, l);
-    memcpy(rb->buffer, from + l, len - l);
-    rb->in += len;
-
-#ifdef ringbuf_USE_MUTEX
-    mutex_unlock(&rb->lock);
-#endif
-    return len;
+    uint32_t in = rb->in;
+    uint32_t used = in - rb_load_acquire(&rb->out);
+    uint32_t accepted = min(len, rb->size - used);
+
+    uint32_t l = min(accepted, rb->size - (in & (rb->size - 1)));
+    memcpy(rb->buffer + (in & (rb->size - 1)), from, l);
+    memcpy(rb->buffer, from + l, accepted - l);
+    rb_store_release(&rb->in, in + accepted);
+
+    if (accepted < len) {
+        rb_store_relaxed(&rb->dropped, rb->dropped + (len - accepted));
+    }
+    update_high_water(rb, used + accepted);
+
+    return accepted;
 }
 
-uint16_t ringbuf_pop(ringbuf_t *rb, uint8_t *dest, uint16_t len)
+uint32_t ringbuf_pop(ringbuf_t *rb, uint8_t *dest, uint32_t len)
 {
-#ifdef ringbuf_USE_MUTEX
-    mutex_lock(&rb->lock);
-#endif
-    unsigned int l;
-    len = min(len, rb->in - rb->out);
-    l = min(len, rb->size - (rb->out & (rb->size - 1)));
-    memcpy(dest, rb->buffer + (rb->out & (rb->size - 1)), l);
+    uint32_t l;
+    uint32_t out = rb->out;
+    uint32_t avail = rb_load_acquire(&rb->in) - out; // 只读取一次in，min宏会重复求值
+    len = min(len, avail);
+    l = min(len, rb->size - (out & (rb->size - 1)));
+    memcpy(dest, rb->buffer + (out & (rb->size - 1)), l);
     memcpy(dest + l, rb->buffer, len - l);
-    rb->out += len;
-
-#ifdef ringbuf_USE_MUTEX
-    mutex_unlock(&rb->lock);
-#endif
+    rb_store_release(&rb->out, out + len);
 
     return len;
 }
@@ -100,23 +125,23 @@ uint16_t ringbuf_pop(ringbuf_t *rb, uint8_t *dest, uint16_t len)
  * @param dest 目标数组（需确保空间足够）
  * @return 实际拷贝的长度（若参数非法或数据不足返回0）
  */
-uint16_t ringbuf_peek(ringbuf_t *rb, uint16_t start, uint16_t len, uint8_t *dest) {
+uint32_t ringbuf_peek(ringbuf_t *rb, uint32_t start, uint32_t len, uint8_t *dest) {
     // 参数检查
     if (!rb || !dest || len == 0) {
         return 0;
     }
 
     // 计算有效数据范围
-    uint16_t avail = rb->in - rb->out;
-    if (start >= avail || (start + len) > avail) {
+    uint32_t avail = ringbuf_len(rb);
+    if (start >= avail || len > avail - start) {
         return 0; // 起始位置或长度越界
     }
 
     // 计算物理位置和分段拷贝
-    uint16_t out_pos = rb->out; // 当前读位置
-    uint16_t first_len = min(len, rb->size - (out_pos & rb->size - 1));
+    uint32_t pos = (rb->out + start) & (rb->size - 1); // 起始物理位置
+    uint32_t first_len = min(len, rb->size - pos);
 
-    memcpy(dest, rb->buffer + (out_pos & (rb->size - 1)), first_len);
+    memcpy(dest, rb->buffer + pos, first_len);
     if (len > first_len) {
         memcpy(dest + first_len, rb->buffer, len - first_len);
     }
@@ -124,38 +149,330 @@ uint16_t ringbuf_peek(ringbuf_t *rb, uint16_t start, uint16_t len, uint8_t *dest
     return len;
 }
 
-uint16_t ringbuf_remove(ringbuf_t *rb, uint16_t len) {
-    unsigned int avail = rb->in - rb->out; 
-    len = min(len, avail); 
-    rb->out += len;
+uint32_t ringbuf_remove(ringbuf_t *rb, uint32_t len) {
+    uint32_t out = rb->out;
+    uint32_t avail = rb_load_acquire(&rb->in) - out;
+    len = min(len, avail);
+    rb_store_release(&rb->out, out + len);
     return len;
 }
 
+/*
+ * 连续内存字节累加
+ * - SSE2：每16字节一次_mm_sad_epu8（对0求绝对差之和即水平字节和）
+ * - 其余：每8字节一次SWAR累加，尾部逐字节
+ * 结果只取低16位，与逐字节uint16_t累加一致
+ */
+static uint32_t sum_bytes(const uint8_t *p, uint32_t len)
+{
+    uint32_t sum = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    if (len >= 16) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i acc = _mm_setzero_si128();
+        while (len >= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+            p += 16;
+            len -= 16;
+        }
+        sum += (uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+    }
+#endif
+
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        // 相邻字节两两相加得到4个16位部分和，再乘法把4个部分和汇总到最高16位
+        v = (v & 0x00FF00FF00FF00FFull) + ((v >> 8) & 0x00FF00FF00FF00FFull);
+        sum += (uint32_t)((v * 0x0001000100010001ull) >> 48);
+        p += 8;
+        len -= 8;
+    }
+
+    while (len--) {
+        sum += *p++;
+    }
+
+    return sum;
+}
+
 /**
  * @brief 计算环形缓冲区中有效数据[n..m]的校验和（16位累加和）
  * @param rb 环形缓冲区指针
  * @param n 起始索引（基于有效数据，0表示第一个可用数据）
  * @param m 结束索引（包含在内）
  * @return 计算出的校验和，若参数非法返回0
+ * @note 按物理上最多两段连续内存分别累加，不再逐字节取模
  */
-uint16_t ringbuf_checksum(ringbuf_t *rb, uint16_t n, uint16_t m) {
-    if (!rb || n > m || m >= rb->in - rb->out) {
+uint16_t ringbuf_checksum(ringbuf_t *rb, uint32_t n, uint32_t m) {
+    if (!rb || n > m || m >= ringbuf_len(rb)) {
         return 0; // 参数非法或越界
     }
 
-    uint16_t sum = 0;
-    uint16_t out_pos = rb->out; // 当前读位置
-    uint16_t size_mask = rb->size - 1;
+    uint32_t pos = (rb->out + n) & (rb->size - 1); // 起始物理位置
+    uint32_t len = m - n + 1;
+    uint32_t first_len = min(len, rb->size - pos);
+
+    uint32_t sum = sum_bytes(rb->buffer + pos, first_len);
+    if (len > first_len) {
+        sum += sum_bytes(rb->buffer, len - first_len);
+    }
+
+    return (uint16_t)sum;
+}
 
-    for (uint16_t i = n; i <= m; i++) {
-        uint16_t pos = (out_pos + i) & size_mask; // 环形索引计算
-        sum += rb->buffer[pos]; // 累加每个字节
+/**
+ * @brief 滑动校验和：由[n..n+len-1]的校验和得到[n+1..n+len]的校验和，O(1)
+ * @param rb 环形缓冲区指针
+ * @param sum 窗口[n..n+len-1]的校验和（ringbuf_checksum或上一次滑动的结果）
+ * @param n 当前窗口起始索引（基于有效数据）
+ * @param len 窗口长度
+ * @return 向后滑动一个字节后的校验和，新窗口越界时返回sum不变
+ * @note 用于重同步时逐字节移动候选包头，避免每个候选都重新累加整个窗口
+ */
+uint16_t ringbuf_checksum_slide(ringbuf_t *rb, uint16_t sum, uint32_t n, uint32_t len) {
+    if (!rb || len == 0 || n + len >= ringbuf_len(rb)) {
+        return sum;
     }
 
-    return sum;
+    return (uint16_t)(sum - ringbuf_get_at(rb, n) + ringbuf_get_at(rb, n + len));
 }
 
-uint16_t ringbuf_len(ringbuf_t *rb)
+// 读端：当前有效数据长度
+uint32_t ringbuf_len(ringbuf_t *rb)
 {
-    return (rb->in - rb->out);
-}
\ No newline at end of file
+    return rb_load_acquire(&rb->in) - rb->out;
+}
+
+/**
+ * @brief 在有效数据[start..]中查找第一个等于value的字节（不修改读指针）
+ * @param rb 环形缓冲区指针
+ * @param start 起始索引（基于有效数据，0表示第一个可用数据）
+ * @param value 要查找的字节值
+ * @return 找到时返回基于有效数据的索引，未找到返回-1
+ * @note 有效数据在物理上最多分为两段连续内存，逐段使用memchr（libc向量化实现）查找
+ */
+int32_t ringbuf_find(ringbuf_t *rb, uint32_t start, uint8_t value)
+{
+    if (!rb) {
+        return -1;
+    }
+
+    uint32_t avail = ringbuf_len(rb);
+    if (start >= avail) {
+        return -1;
+    }
+
+    uint32_t size_mask = rb->size - 1;
+    uint32_t pos = (rb->out + start) & size_mask;   // 起始物理位置
+    uint32_t len = avail - start;                   // 待查找长度
+    uint32_t first_len = min(len, rb->size - pos);  // 第一段长度（到缓冲区末尾）
+
+    const uint8_t *hit = (const uint8_t *)memchr(rb->buffer + pos, value, first_len);
+    if (hit) {
+        return (int32_t)(start + (uint32_t)(hit - (rb->buffer + pos)));
+    }
+
+    if (len > first_len) {
+        hit = (const uint8_t *)memchr(rb->buffer, value, len - first_len);
+        if (hit) {
+            return (int32_t)(start + first_len + (uint32_t)(hit - rb->buffer));
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 在有效数据[start..]中查找第一个等于a或b的字节（不修改读指针）
+ * @param rb 环形缓冲区指针
+ * @param start 起始索引（基于有效数据）
+ * @param a 要查找的字节值
+ * @param b 要查找的另一个字节值
+ * @return 找到时返回基于有效数据的索引，未找到返回-1
+ * @note 先用memchr找a，再只在a之前的范围内找b，两次查找合计不超过一遍数据
+ */
+int32_t ringbuf_find2(ringbuf_t *rb, uint32_t start, uint8_t a, uint8_t b)
+{
+    if (!rb) {
+        return -1;
+    }
+
+    uint32_t avail = ringbuf_len(rb);
+    if (start >= avail) {
+        return -1;
+    }
+
+    uint32_t pos = (rb->out + start) & (rb->size - 1);
+    uint32_t len = avail - start;
+    uint32_t first_len = min(len, rb->size - pos);
+    const uint8_t *segs[2] = { rb->buffer + pos, rb->buffer };
+    uint32_t seg_lens[2] = { first_len, len - first_len };
+    uint32_t base = start;
+
+    for (int i = 0; i < 2 && seg_lens[i] > 0; ++i) {
+        const uint8_t *hit = (const uint8_t *)memchr(segs[i], a, seg_lens[i]);
+        uint32_t limit = hit ? (uint32_t)(hit - segs[i]) : seg_lens[i];
+        const uint8_t *hit_b = limit > 0 ? (const uint8_t *)memchr(segs[i], b, limit) : NULL;
+        if (hit_b) {
+            return (int32_t)(base + (uint32_t)(hit_b - segs[i]));
+        }
+        if (hit) {
+            return (int32_t)(base + limit);
+        }
+        base += seg_lens[i];
+    }
+
+    return -1;
+}
+
+// CRC-16/CCITT-FALSE（多项式0x1021），按字节查表
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+static uint16_t crc16_update(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(uint8_t)((crc >> 8) ^ data[i])]);
+    }
+    return crc;
+}
+
+/**
+ * @brief 计算有效数据[n..n+len-1]的CRC-16/CCITT-FALSE（初值0xFFFF，不反转）
+ * @param rb 环形缓冲区指针
+ * @param n 起始索引（基于有效数据）
+ * @param len 参与计算的字节数
+ * @return CRC值，越界时返回0
+ * @note 用于v2变长协议帧校验，按两段连续内存分别累计
+ */
+uint16_t ringbuf_crc16(ringbuf_t *rb, uint32_t n, uint32_t len)
+{
+    if (!rb || n + len > ringbuf_len(rb)) {
+        return 0;
+    }
+
+    uint32_t pos = (rb->out + n) & (rb->size - 1);
+    uint32_t first_len = min(len, rb->size - pos);
+
+    uint16_t crc = crc16_update(0xFFFF, rb->buffer + pos, first_len);
+    if (len > first_len) {
+        crc = crc16_update(crc, rb->buffer, len - first_len);
+    }
+    return crc;
+}
+
+/**
+ * @brief 获取可写区域（零拷贝写入，写端）
+ * @param rb 环形缓冲区指针
+ * @param spans 输出的两段可写区间，第二段在空闲区不回绕时长度为0
+ * @return 可写的总字节数
+ * @note 写入数据后调用ringbuf_commit()提交，提交前数据对读端不可见
+ */
+uint32_t ringbuf_get_write_spans(ringbuf_t *rb, ringbuf_span_t spans[2])
+{
+    uint32_t free_len = rb->size - (rb->in - rb_load_acquire(&rb->out));
+    uint32_t pos = rb->in & (rb->size - 1);
+    uint32_t first_len = min(free_len, rb->size - pos);
+
+    spans[0].data = rb->buffer + pos;
+    spans[0].len = first_len;
+    spans[1].data = rb->buffer;
+    spans[1].len = free_len - first_len;
+
+    return free_len;
+}
+
+/**
+ * @brief 提交已直接写入可写区域的数据（写端）
+ * @param rb 环形缓冲区指针
+ * @param len 已写入的字节数
+ * @return 实际提交的字节数（不超过空闲空间）
+ */
+uint32_t ringbuf_commit(ringbuf_t *rb, uint32_t len)
+{
+    uint32_t in = rb->in;
+    uint32_t used = in - rb_load_acquire(&rb->out);
+    len = min(len, rb->size - used);
+    rb_store_release(&rb->in, in + len);
+    update_high_water(rb, used + len);
+    return len;
+}
+
+/**
+ * @brief 获取可读区域（零拷贝读取，读端）
+ * @param rb 环形缓冲区指针
+ * @param spans 输出的两段可读区间，第二段在数据不回绕时长度为0
+ * @return 可读的总字节数
+ * @note 处理完数据后调用ringbuf_consume()释放
+ */
+uint32_t ringbuf_get_read_spans(ringbuf_t *rb, ringbuf_span_t spans[2])
+{
+    uint32_t avail = ringbuf_len(rb);
+    uint32_t pos = rb->out & (rb->size - 1);
+    uint32_t first_len = min(avail, rb->size - pos);
+
+    spans[0].data = rb->buffer + pos;
+    spans[0].len = first_len;
+    spans[1].data = rb->buffer;
+    spans[1].len = avail - first_len;
+
+    return avail;
+}
+
+/**
+ * @brief 释放已通过可读区域处理完的数据（读端）
+ * @param rb 环形缓冲区指针
+ * @param len 要释放的字节数
+ * @return 实际释放的字节数
+ */
+uint32_t ringbuf_consume(ringbuf_t *rb, uint32_t len)
+{
+    return ringbuf_remove(rb, len);
+}
+
+// 缓冲区满而丢弃的累计字节数
+uint32_t ringbuf_dropped(ringbuf_t *rb)
+{
+    return rb_load_relaxed(&rb->dropped);
+}
+
+// 历史最高数据量
+uint32_t ringbuf_high_water(ringbuf_t *rb)
+{
+    return rb_load_relaxed(&rb->high_water);
+}
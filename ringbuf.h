@@ -2,37 +2,77 @@
 #define __RINGBUF_H_
 
 #include <stdint.h>
-#include <stdlib.h>  
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define RINGBUF_CACHELINE 64  // 缓存行大小，用于隔离生产者/消费者字段
+
+/*
+ * 单生产者/单消费者（SPSC）无锁环形缓冲区
+ * - 生产者（写端）只修改in，消费者（读端）只修改out，通过acquire/release同步，无需加锁
+ * - 写端接口：ringbuf_push / ringbuf_get_write_spans / ringbuf_commit
+ * - 读端接口：ringbuf_pop / ringbuf_peek / ringbuf_remove / ringbuf_consume /
+ *            ringbuf_get_read_spans / ringbuf_checksum / ringbuf_checksum_slide /
+ *            ringbuf_find / ringbuf_find2 / ringbuf_crc16 / ringbuf_get_at
+ * - 32位索引，容量为2的幂，最大2GB
+ * - in/out分处不同缓存行，避免读写线程之间的伪共享
+ */
 typedef struct {
+    // 只读字段（创建后不变）
     uint8_t *buffer;      // 数据缓冲区指针
-    uint16_t size;        // 缓冲区大小(必须是2的幂)
-    uint16_t in;        // 写入指针
-    uint16_t out;        // 读取指针
-#ifdef ringbuf_USE_MUTEX
-    mutex_t lock;         // 互斥锁
-#endif
+    uint32_t size;        // 缓冲区大小(必须是2的幂)
+    uint8_t pad0[RINGBUF_CACHELINE - sizeof(uint8_t *) - sizeof(uint32_t)];
+
+    // 生产者字段
+    uint32_t in;          // 写入指针
+    uint32_t dropped;     // 缓冲区满而丢弃的字节数
+    uint32_t high_water;  // 历史最高数据量（高水位）
+    uint8_t pad1[RINGBUF_CACHELINE - 3 * sizeof(uint32_t)];
+
+    // 消费者字段
+    uint32_t out;         // 读取指针
+    uint8_t pad2[RINGBUF_CACHELINE - sizeof(uint32_t)];
 } ringbuf_t;
 
+// 连续内存区间（环形缓冲区的可读/可写区域最多由两段组成）
+typedef struct {
+    uint8_t *data;        // 区间起始地址
+    uint32_t len;         // 区间长度
+} ringbuf_span_t;
+
 // 函数声明
-ringbuf_t *ringbuf_alloc(uint16_t size);
+ringbuf_t *ringbuf_alloc(uint32_t size);
 void ringbuf_free(ringbuf_t *rb);
-uint16_t ringbuf_push(ringbuf_t *rb, const uint8_t *from, uint16_t len);
-uint16_t ringbuf_pop(ringbuf_t *rb, uint8_t *dest, uint16_t len);
-uint16_t ringbuf_peek(ringbuf_t *rb, uint16_t start, uint16_t len, uint8_t *dest);
-uint16_t ringbuf_remove(ringbuf_t *rb, uint16_t len);
-uint16_t ringbuf_checksum(ringbuf_t *rb, uint16_t n, uint16_t m);
-uint16_t ringbuf_len(ringbuf_t *rb);
+uint32_t ringbuf_push(ringbuf_t *rb, const uint8_t *from, uint32_t len);
+uint32_t ringbuf_pop(ringbuf_t *rb, uint8_t *dest, uint32_t len);
+uint32_t ringbuf_peek(ringbuf_t *rb, uint32_t start, uint32_t len, uint8_t *dest);
+uint32_t ringbuf_remove(ringbuf_t *rb, uint32_t len);
+uint16_t ringbuf_checksum(ringbuf_t *rb, uint32_t n, uint32_t m);
+uint16_t ringbuf_checksum_slide(ringbuf_t *rb, uint16_t sum, uint32_t n, uint32_t len);
+uint32_t ringbuf_len(ringbuf_t *rb);
+int32_t ringbuf_find(ringbuf_t *rb, uint32_t start, uint8_t value);
+int32_t ringbuf_find2(ringbuf_t *rb, uint32_t start, uint8_t a, uint8_t b);
+uint16_t ringbuf_crc16(ringbuf_t *rb, uint32_t n, uint32_t len);
+
+// 零拷贝接口：直接访问可写/可读区域，完成后提交/消费
+uint32_t ringbuf_get_write_spans(ringbuf_t *rb, ringbuf_span_t spans[2]);
+uint32_t ringbuf_commit(ringbuf_t *rb, uint32_t len);
+uint32_t ringbuf_get_read_spans(ringbuf_t *rb, ringbuf_span_t spans[2]);
+uint32_t ringbuf_consume(ringbuf_t *rb, uint32_t len);
+
+// 溢出统计（任意线程可读）
+uint32_t ringbuf_dropped(ringbuf_t *rb);
+uint32_t ringbuf_high_water(ringbuf_t *rb);
 
 // 宏定义
+// ringbuf_clear 同时修改读写指针，只能在读写两端都不访问时使用
 #define ringbuf_clear(rb) do { (rb)->in = (rb)->out = 0; } while(0)
 #define ringbuf_get_read_ptr(rb) ((rb)->buffer + ((rb)->out & ((rb)->size - 1)))
 #define ringbuf_get_at(rb, n) ((rb)->buffer[((rb)->out + (n)) & ((rb)->size - 1)])
-#define ringbuf_is_empty(rb) ((rb)->in == (rb)->out ? 1 : 0)
+#define ringbuf_is_empty(rb) (ringbuf_len(rb) == 0 ? 1 : 0)
 #define ringbuf_get_write_ptr(rb) ((rb)->buffer + ((rb)->in & ((rb)->size - 1)))
 
 #ifdef __cplusplus
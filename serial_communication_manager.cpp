@@ -1,60 +1,127 @@
 #include "serial_communication_manager.h"
-#include <QtConcurrent>
+#include "simulated_device.h"
+#include <QMetaMethod>
+#include <QStandardPaths>
+#include <QDir>
 
 SerialCommunicationManager::SerialCommunicationManager(QObject *parent)
     : QObject(parent)
-    , m_serialPort(new QSerialPort(this))
+    , m_ioThread(new QThread(this))
+    , m_ioWorker(new SerialIoWorker())
     , m_isConnected(false)
     , m_connectionStatus("未连接")
     , m_showTx(true)
     , m_showRx(true)
     , m_hexDisplay(true)
     , m_bytesReceived(0)
+    , m_bytesReceivedBase(0)
     , m_bytesSent(0)
+    , m_bytesSentBase(0)
+    , m_trafficLog(new TrafficLogModel(TrafficLogModel::DEFAULT_CAPACITY, TrafficLogModel::DEFAULT_ARENA_BYTES, this))
+    , m_recorder(new SessionRecorder(this))
+    , m_baudRate(0)
+    , m_replaySpeed(1.0)
+    , m_lastReplayBytes(0)
+    , m_replayBytesPerSecond(0.0)
+    , m_replayFramesPerSecond(0.0)
+    , m_rxDecodeLatencyUs(0.0)
+    , m_rxDispatchLatencyUs(0.0)
+    , m_rxDispatchLatencyMaxUs(0.0)
+    , m_framesPerWakeup(0.0)
+    , m_maxFramesPerWakeup(0)
+    , m_transactionsPerSecond(0.0)
+    , m_requestRttUs(0.0)
+    , m_requestRttMaxUs(0.0)
+    , m_lastTxStatsNs(monotonicNowNs())
+    , m_framesPerWrite(0.0)
+    , m_bytesPerWrite(0.0)
+    , m_cmdQueueDepth(0)
+    , m_cmdQueueOldestAgeMs(0.0)
     , m_updateTimer(new QTimer(this))
-    , m_stopCmdThread(false)
 {
-    // 连接串口信号
-    connect(m_serialPort, &QSerialPort::readyRead, this, &SerialCommunicationManager::onReadyRead);
-    connect(m_serialPort, QOverload<QSerialPort::SerialPortError>::of(&QSerialPort::errorOccurred),
-            this, &SerialCommunicationManager::onErrorOccurred);
+    // 串口I/O工作对象移动到独立线程，串口的读写与解包均在该线程完成
+    m_ioThread->setObjectName("SerialIoThread");
+    m_ioWorker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_ioWorker, &QObject::deleteLater);
+    m_ioWorker->setRecorder(m_recorder);
+    
+    // 连接I/O线程信号（跨线程，自动使用队列连接）
+    connect(m_ioWorker, &SerialIoWorker::dataRead, this, &SerialCommunicationManager::onDataRead);
+    connect(m_ioWorker, &SerialIoWorker::dataWritten, this, &SerialCommunicationManager::onDataWritten);
+    connect(m_ioWorker, &SerialIoWorker::framesReady, this, &SerialCommunicationManager::onFramesReady);
+    connect(m_ioWorker, &SerialIoWorker::portErrorOccurred, this, &SerialCommunicationManager::onPortErrorOccurred);
+    connect(m_ioWorker, &SerialIoWorker::errorOccurred, this, &SerialCommunicationManager::errorOccurred);
+    connect(m_recorder, &SessionRecorder::errorOccurred, this, [this](const QString &error) {
+        stopRecording();
+        emit errorOccurred(error);
+    });
+    
+    m_ioThread->start(QThread::TimeCriticalPriority);
     
-    // 设置定时器，每100ms更新一次字节计数显示
+    // 设置定时器，每100ms更新一次字节计数和延迟统计显示
     connect(m_updateTimer, &QTimer::timeout, [this]() {
+        m_bytesReceived = m_ioWorker->totalBytesRead() - m_bytesReceivedBase;
+        m_bytesSent = m_ioWorker->totalBytesWritten() - m_bytesSentBase;
         emit bytesReceivedChanged();
         emit bytesSentChanged();
+        
+        m_rxDecodeLatencyUs = m_rxDecodeLatency.avgUs();
+        m_rxDispatchLatencyUs = m_rxDispatchLatency.avgUs();
+        m_rxDispatchLatencyMaxUs = m_rxDispatchLatency.maxUs();
+        m_rxDecodeLatency.reset();
+        m_rxDispatchLatency.reset();
+        
+        qint64 wakeups = 0, frames = 0;
+        m_ioWorker->takeWakeupStats(wakeups, frames, m_maxFramesPerWakeup);
+        m_framesPerWakeup = wakeups > 0 ? double(frames) / wakeups : 0.0;
+        emit rxLatencyChanged();
+        
+        qint64 completed = 0, rttSumNs = 0, rttMaxNs = 0;
+        m_ioWorker->takeTxStats(completed, rttSumNs, rttMaxNs);
+        qint64 nowNs = monotonicNowNs();
+        qint64 elapsedNs = nowNs - m_lastTxStatsNs;
+        m_lastTxStatsNs = nowNs;
+        m_transactionsPerSecond = elapsedNs > 0 ? completed * 1e9 / elapsedNs : 0.0;
+        m_requestRttUs = completed > 0 ? rttSumNs / 1000.0 / completed : 0.0;
+        m_requestRttMaxUs = rttMaxNs / 1000.0;
+        
+        qint64 writes = 0, writeFrames = 0, writeBytes = 0;
+        m_ioWorker->takeWriteStats(writes, writeFrames, writeBytes);
+        m_framesPerWrite = writes > 0 ? double(writeFrames) / writes : 0.0;
+        m_bytesPerWrite = writes > 0 ? double(writeBytes) / writes : 0.0;
+        emit txStatsChanged();
+        
+        if (isReplaying()) {
+            // 定位后送出字节数会回退，这一周期按0计
+            qint64 replayBytes = m_ioWorker->replayBytes();
+            m_replayBytesPerSecond = elapsedNs > 0 ? qMax<qint64>(0, replayBytes - m_lastReplayBytes) * 1e9 / elapsedNs : 0.0;
+            m_replayFramesPerSecond = elapsedNs > 0 ? frames * 1e9 / elapsedNs : 0.0;
+            m_lastReplayBytes = replayBytes;
+            emit replayStatsChanged();
+        }
+        
+        qint64 oldestAgeNs = 0;
+        m_ioWorker->cmdQueueStats(m_cmdQueueDepth, oldestAgeNs);
+        m_cmdQueueOldestAgeMs = oldestAgeNs / 1e6;
+        emit cmdQueueChanged();
+        
+        if (m_recorder->isRecording()) {
+            emit recordingStatsChanged();
+        }
     });
     m_updateTimer->start(100); // 100ms更新一次
     
-    // 启动命令处理线程
-    QThreadPool::globalInstance()->start([this]() {
-        this->processCmdQueue();
-    });
-    
-    // 初始化协议接收环形缓冲区
-    m_rxRingbuf = ringbuf_alloc(1024); // 创建1KB的接收缓冲区
-    
     // 初始化可用端口列表
     scanAvailablePorts();
 }
 
 SerialCommunicationManager::~SerialCommunicationManager()
 {
-    // 停止命令处理线程
-    m_stopCmdThread = true;
-    m_cmdCondition.wakeAll(); // 唤醒等待的线程
-    
-    // 等待一段时间让线程安全退出
-    QThread::msleep(100);
-    
-    // 释放协议接收环形缓冲区
-    if (m_rxRingbuf) {
-        ringbuf_free(m_rxRingbuf);
-        m_rxRingbuf = nullptr;
-    }
-    
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
+    // 关闭串口并停止I/O线程
+    if (m_ioThread->isRunning()) {
+        QMetaObject::invokeMethod(m_ioWorker, &SerialIoWorker::closePort, Qt::BlockingQueuedConnection);
+        m_ioThread->quit();
+        m_ioThread->wait();
     }
 }
 
@@ -64,27 +131,24 @@ bool SerialCommunicationManager::connectPort(const QString &portName, int baudRa
         disconnectPort();
     }
     
-    m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(baudRate);
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::NoParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    // 在I/O线程中打开串口，等待结果
+    QString error;
+    QMetaObject::invokeMethod(m_ioWorker, [this, portName, baudRate]() {
+        return m_ioWorker->openPort(portName, baudRate);
+    }, Qt::BlockingQueuedConnection, &error);
     
-    if (m_serialPort->open(QIODevice::ReadWrite)) {
+    if (error.isEmpty()) {
         m_isConnected = true;
+        m_portName = portName;
+        m_baudRate = baudRate;
         m_connectionStatus = QString("已连接到 %1 (%2)").arg(portName).arg(baudRate);
         emit connectionStateChanged();
         emit connectionStatusChanged();
         
-        // 唤醒命令处理线程（串口已连接）
-        m_cmdCondition.wakeAll();
-        
         // 不再显示连接成功消息到数据区域
         // appendToDataList(QString("[系统] 串口连接成功: %1 @ %2").arg(portName).arg(baudRate), false);
         return true;
     } else {
-        QString error = m_serialPort->errorString();
         m_connectionStatus = QString("连接失败: %1").arg(error);
         emit connectionStatusChanged();
         emit errorOccurred(error);
@@ -94,18 +158,14 @@ bool SerialCommunicationManager::connectPort(const QString &portName, int baudRa
 
 void SerialCommunicationManager::disconnectPort()
 {
-    if (m_serialPort->isOpen()) {
-        QString portName = m_serialPort->portName();
-        m_serialPort->close();
+    if (m_isConnected) {
+        QMetaObject::invokeMethod(m_ioWorker, &SerialIoWorker::closePort, Qt::BlockingQueuedConnection);
         
         m_isConnected = false;
         m_connectionStatus = "未连接";
         emit connectionStateChanged();
         emit connectionStatusChanged();
         
-        // 唤醒命令处理线程（让线程检查连接状态并等待）
-        m_cmdCondition.wakeAll();
-        
         // 不再显示断开连接消息到数据区域
         // appendToDataList(QString("[系统] 串口已断开: %1").arg(portName), false);
     }
@@ -119,38 +179,24 @@ bool SerialCommunicationManager::sendData(const QString &data)
     }
     
     QByteArray sendData = parseInputString(data);
-    qint64 bytesWritten = m_serialPort->write(sendData);
-    
-    if (bytesWritten > 0) {
-        // 更新发送字节计数
-        m_bytesSent += bytesWritten;
-        
-        QString formattedData = formatData(sendData, true);
-        
-        // *** 优化：根据显示设置决定是否将数据添加到缓冲区 ***
-        // 只有当用户选择显示发送数据时，才将数据添加到内部缓冲区
-        // 这样可以避免不必要的数据搬运，提高性能
-        if (m_showTx) {
-            appendToDataList(formattedData, true);
-        }
-        
-        QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-        emit dataSent(formattedData, timestamp);
-        return true;
-    } else {
-        QString error = "发送数据失败: " + m_serialPort->errorString();
-        emit errorOccurred(error);
+    if (sendData.isEmpty()) {
         return false;
     }
+    
+    // 交给I/O线程写入，写入结果通过dataWritten/errorOccurred返回
+    QMetaObject::invokeMethod(m_ioWorker, [this, sendData]() {
+        m_ioWorker->writeRaw(sendData);
+    }, Qt::QueuedConnection);
+    return true;
 }
 
 void SerialCommunicationManager::clearData()
 {
-    m_dataList.clear();
-    m_displayData.clear();
+    m_trafficLog->clear();
     m_bytesReceived = 0;
+    m_bytesReceivedBase = m_ioWorker->totalBytesRead();
     m_bytesSent = 0;
-    emit displayDataChanged();
+    m_bytesSentBase = m_ioWorker->totalBytesWritten();
     emit bytesReceivedChanged();
     emit bytesSentChanged();
 }
@@ -160,56 +206,48 @@ void SerialCommunicationManager::refreshPorts()
     scanAvailablePorts();
 }
 
-void SerialCommunicationManager::onReadyRead()
+void SerialCommunicationManager::onDataRead(const QByteArray &data, qint64 timestampNs)
 {
-    // 从串口读取所有可用数据
-    // 注意：readAll()会一次性读取缓冲区中的所有数据，可能导致多个数据包被合并
-    QByteArray data = m_serialPort->readAll();
+    // I/O线程已完成读取与协议解析，这里只负责显示
+    // 接收字节计数由I/O线程累计，定时刷新
+    // *** 优化：根据显示设置决定是否记录 ***
+    // 只有当用户选择显示接收数据时，才记录到收发列表；记录只保存原始字节，显示时才格式化
+    if (m_showRx) {
+        // false表示这是接收的数据（而非发送的数据）
+        m_trafficLog->append(data, false, timestampNs);
+    }
     
-    // 防御性编程：确保确实读取到了数据
-    if (!data.isEmpty()) {
-        // 更新接收字节计数
-        m_bytesReceived += data.size();
-        
-        // 将接收到的数据写入环形缓冲区
-        if (m_rxRingbuf) {
-            ringbuf_push(m_rxRingbuf, reinterpret_cast<const uint8_t*>(data.constData()), data.size());
-            // 调用协议解析函数
-            parseProtocol();
-        }
-        
-        // 将原始二进制数据格式化为可显示的字符串
-        // formatData()会处理非打印字符、根据m_hexDisplay设置进行HEX转换等
-        QString formattedData = formatData(data, false);
-        
-        // *** 优化：根据显示设置决定是否将数据添加到缓冲区 ***
-        // 只有当用户选择显示接收数据时，才将数据添加到内部缓冲区
-        // 这样可以避免不必要的数据搬运，提高性能
-        if (m_showRx) {
-            // false表示这是接收的数据（而非发送的数据）
-            appendToDataList(formattedData, false);
-        }
-        
+    // 发射信号通知其他模块有新数据到达
+    // 注意：目前这个信号没有连接到任何消费者，是预留接口（仅在显示接收数据时发射）
+    // 其他模块（如FOC曲线打印、数据解析等）可以通过连接此信号来获取数据；无人连接时不做格式化
+    if (isSignalConnected(QMetaMethod::fromSignal(&SerialCommunicationManager::dataReceived))) {
         // 生成精确到毫秒的时间戳，用于日志记录
         QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-        
-        // 发射信号通知其他模块有新数据到达
-        // 注意：目前这个信号没有连接到任何消费者，是预留接口
-        // 其他模块（如FOC曲线打印、数据解析等）可以通过连接此信号来获取数据
-        emit dataReceived(formattedData, timestamp);
+        emit dataReceived(formatData(data, false), timestamp);
     }
 }
 
-void SerialCommunicationManager::onErrorOccurred(QSerialPort::SerialPortError error)
+void SerialCommunicationManager::onDataWritten(const QByteArray &data, qint64 timestampNs)
 {
-    if (error != QSerialPort::NoError) {
-        QString errorString = m_serialPort->errorString();
-        m_connectionStatus = QString("错误: %1").arg(errorString);
-        emit connectionStatusChanged();
-        emit errorOccurred(errorString);
+    // 发送字节计数由I/O线程累计，定时刷新；此信号仅在显示发送数据时到达
+    // 根据显示设置决定是否显示
+    if (m_showTx) {
+        m_trafficLog->append(data, true, timestampNs);
+    }
+    
+    if (isSignalConnected(QMetaMethod::fromSignal(&SerialCommunicationManager::dataSent))) {
+        QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
+        emit dataSent(formatData(data, true), timestamp);
     }
 }
 
+void SerialCommunicationManager::onPortErrorOccurred(const QString &error)
+{
+    m_connectionStatus = QString("错误: %1").arg(error);
+    emit connectionStatusChanged();
+    emit errorOccurred(error);
+}
+
 void SerialCommunicationManager::scanAvailablePorts()
 {
     m_availablePorts.clear();
@@ -248,23 +286,18 @@ void SerialCommunicationManager::scanAvailablePorts()
         m_availablePortDetails.append(detail);
     }
     
+    // 模拟电机始终可选，无硬件时用于调试收发与曲线
+    m_availablePorts.append(SimulatedDevice::PORT_NAME);
+    m_availablePortDetails.append(QString("%1 - 模拟电机").arg(SimulatedDevice::PORT_NAME));
+    
     emit availablePortsChanged();
     emit availablePortDetailsChanged();
 }
 
 QString SerialCommunicationManager::formatData(const QByteArray &data, bool isTx)
 {
-    QString result;
-    if (m_hexDisplay) {
-        result = byteArrayToHex(data);
-    } else {
-        result = QString::fromLatin1(data);
-        // 处理非打印字符
-        result.replace('\r', "\\r");
-        result.replace('\n', "\\n");
-        result.replace('\t', "\\t");
-    }
-    return result;
+    Q_UNUSED(isTx);
+    return TrafficLogModel::formatBytes(data, m_hexDisplay);
 }
 
 QByteArray SerialCommunicationManager::parseInputString(const QString &input)
@@ -279,297 +312,258 @@ QByteArray SerialCommunicationManager::parseInputString(const QString &input)
     }
 }
 
-QString SerialCommunicationManager::byteArrayToHex(const QByteArray &data)
+void SerialCommunicationManager::updateAvailablePorts()
 {
-    QString hex;
-    for (int i = 0; i < data.size(); ++i) {
-        hex.append(QString("%1 ").arg((unsigned char)data[i], 2, 16, QChar('0')).toUpper());
-    }
-    return hex.trimmed();
+    // 调用现有的scanAvailablePorts()方法来实现相同功能
+    scanAvailablePorts();
 }
 
-void SerialCommunicationManager::appendToDataList(const QString &data, bool isTx)
+void SerialCommunicationManager::resetByteCounters()
 {
-    DataItem item;
-    item.data = data;
-    item.timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    item.isTx = isTx;
-    
-    m_dataList.append(item);
-    
-    // 限制数据量，防止缓冲区无限增长
-    if (m_dataList.size() > MAX_LINES) {
-        m_dataList.removeFirst();  // 移除最老的数据
-    }
-    
-    updateDisplayData();
+    m_bytesReceived = 0;
+    m_bytesReceivedBase = m_ioWorker->totalBytesRead();
+    m_bytesSent = 0;
+    m_bytesSentBase = m_ioWorker->totalBytesWritten();
+    emit bytesReceivedChanged();
+    emit bytesSentChanged();
 }
 
-void SerialCommunicationManager::updateDisplayData()
+bool SerialCommunicationManager::pushCmd(const QByteArray &data, motor_command_t cmd, int priority)
 {
-    QString display;
-    for (const DataItem &item : m_dataList) {
-        // *** 修改：移除过滤逻辑，因为数据添加阶段已经过滤 ***
-        // 数据已经在添加阶段根据显示设置进行了过滤，这里直接显示即可
-        
-        QString prefix = item.isTx ? "[发送] " : "[接收] ";
-        QString line = QString("%1 %2: %3\n")
-                          .arg(item.timestamp)
-                          .arg(prefix)
-                          .arg(item.data);
-        display.append(line);
+    // 验证数据长度是否为10字节
+    if (data.size() != PROTOCOL_DATA_LENGTH) {
+        qDebug() << "数据长度错误：期望10字节，实际" << data.size() << "字节";
+        return false;
     }
     
-    if (m_displayData != display) {
-        m_displayData = display;
-        emit displayDataChanged();
-    }
+    // 构建完整的14字节命令包（包头、命令字、数据、校验和、包尾）
+    return pushFrame(ProtocolEncoder::encode(uint8_t(cmd), reinterpret_cast<const uint8_t*>(data.constData()), PROTOCOL_DATA_LENGTH), priority);
 }
 
-void SerialCommunicationManager::updateAvailablePorts()
+bool SerialCommunicationManager::requestProtocolVersion(int version, int maxBlockMs)
 {
-    // 调用现有的scanAvailablePorts()方法来实现相同功能
-    scanAvailablePorts();
+    // 协商请求本身是v1帧；电机不支持时不应答，超时后仍使用v1
+    ProtocolFrame frame = ProtocolEncoder::encodeNegotiate(uint8_t(qBound(1, version, 2)), PROTOCOL_V2_MAX_PAYLOAD,
+                                                           uint16_t(qBound(1, maxBlockMs, 1000)));
+    return pushFrame(frame, TX_PRIORITY_PARAM);
 }
 
-void SerialCommunicationManager::resetByteCounters()
+bool SerialCommunicationManager::pushFrame(const ProtocolFrame &frame, int priority)
 {
-    m_bytesReceived = 0;
-    m_bytesSent = 0;
-    emit bytesReceivedChanged();
-    emit bytesSentChanged();
+    return pushFrames(&frame, 1, priority);
 }
 
-void SerialCommunicationManager::processCmdQueue()
+bool SerialCommunicationManager::pushFrames(const ProtocolFrame *frames, int count, int priority, bool reportFull)
 {
-    qDebug() << "命令处理线程已启动";
+    AllocCounter::Scope countAllocations;
     
-    while (!m_stopCmdThread) {
-        QByteArray cmd;
-        
-        // 从队列中获取命令
-        {
-            QMutexLocker locker(&m_cmdMutex);
-            
-            // 等待条件：有命令可用且串口已连接，或者需要停止线程
-            while (!m_stopCmdThread && (m_cmdList.isEmpty() || !m_isConnected)) {
-                qDebug() << "命令处理线程等待中... 队列大小:" << m_cmdList.size() 
-                         << "连接状态:" << m_isConnected;
-                m_cmdCondition.wait(&m_cmdMutex);
-            }
-            
-            // 检查是否需要停止线程
-            if (m_stopCmdThread) {
-                break;
-            }
-            
-            // 再次检查是否有命令可用（可能被其他线程消费）
-            if (m_cmdList.isEmpty()) {
-                continue;
-            }
-            
-            cmd = m_cmdList.takeFirst();
-        }
-        
-        // 只有在串口连接时才发送命令
-        if (m_isConnected && !cmd.isEmpty()) {
-            qint64 bytesWritten = m_serialPort->write(cmd);
-            if (bytesWritten > 0) {
-                // 更新发送字节计数
-                m_serialPort->flush();
-                m_bytesSent += bytesWritten;
-                emit bytesSentChanged();
-                
-                QString formattedData = formatData(cmd, true);
-                QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-                
-                // 根据显示设置决定是否显示
-                if (m_showTx) {
-                    appendToDataList(formattedData, true);
-                }
-                
-                emit dataSent(formattedData, timestamp);
-                qDebug() << "命令已发送，长度：" << bytesWritten << "字节";
-            } else {
-                QString error = "发送命令失败: " + m_serialPort->errorString();
-                emit errorOccurred(error);
-                qDebug() << error;
-            }
-        } else {
-            qDebug() << "串口未连接，命令发送失败";
+    // 将命令添加到I/O线程的发送队列
+    int queueSize = m_ioWorker->enqueueCmds(frames, count, priority);
+    if (queueSize < 0) {
+        if (!reportFull) {
+            return false; // 由调用方计数（周期读取每个节拍都会被拒绝，逐次报错会刷屏）
         }
-        
-        // 发送间隔，避免过快发送
-        QThread::msleep(10);
+        AllocCounter::Pause pause;
+        emit errorOccurred(count == 1 ? "命令队列已满，命令字: 0x" + QString::number(frames[0][1], 16).toUpper()
+                                      : QString("命令队列已满，%1条命令中有未入队的命令").arg(count));
+        return false;
     }
-    
-    qDebug() << "命令处理线程已停止";
+    return true;
 }
 
-bool SerialCommunicationManager::pushCmd(const QByteArray &data, motor_command_t cmd)
+void SerialCommunicationManager::onFramesReady()
 {
-    // 验证数据长度是否为10字节
-    if (data.size() != 10) {
-        qDebug() << "数据长度错误：期望10字节，实际" << data.size() << "字节";
-        return false;
-    }
-    
-    // 构建完整的14字节命令包
-    QByteArray fullCmd;
-    fullCmd.resize(PROTOCOL_LENGTH);
+    // 先清除通知标志再取帧，保证取帧期间新到的帧会再次通知
+    m_ioWorker->clearFramesNotify();
     
-    // 添加包头
-    fullCmd[0] = PROTOCOL_HEADER;
-    
-    // 添加命令字
-    fullCmd[1] = static_cast<uint8_t>(cmd);
-    
-    // 添加10字节数据
-    for (int i = 0; i < 10; i++) {
-        fullCmd[2 + i] = static_cast<uint8_t>(data[i]);
+    m_rxBatch.clear();
+    RxFrame frame;
+    while (m_ioWorker->popFrame(frame)) {
+        m_rxBatch.append(frame);
     }
     
-    // 计算校验和（从包头到数据区结束，不包括包尾和校验字节本身）
-    uint16_t checksum = 0;
-    for (int i = 0; i < 12; i++) { // 0-11字节（包头+命令字+10字节数据）
-        checksum += static_cast<uint8_t>(fullCmd[i]);
-    }
-    fullCmd[12] = static_cast<uint8_t>(checksum & 0xFF); // 取低8位
-    
-    // 添加包尾
-    fullCmd[13] = PROTOCOL_FOOTER;
-    
-    // 将命令添加到队列
-    {
-        QMutexLocker locker(&m_cmdMutex);
-        m_cmdList.append(fullCmd);
-        qDebug() << "命令已添加到队列，当前队列长度：" << m_cmdList.size() 
-                 << "命令字: 0x" << QString::number(cmd, 16).toUpper();
+    // v2批量数据帧：单独一批
+    m_rxBlockBatch.clear();
+    RxBlock block;
+    while (m_ioWorker->popBlock(block)) {
+        m_rxBlockBatch.append(block);
     }
     
-    // 唤醒命令处理线程
-    m_cmdCondition.wakeOne();
-    
-    return true;
-}
-
-void SerialCommunicationManager::parseProtocol()
-{
-    // 协议解析方法
-    // 创建一个临时ringbuf指针，指向接收缓冲区
-    ringbuf_t *cmd_rb = m_rxRingbuf;
-    
-    uint8_t cmd_len = 0;
-    
-    // 查找协议包头
-    while(1) {
-        uint16_t rb_len = ringbuf_len(cmd_rb);
-        
-        if(rb_len < PROTOCOL_LENGTH) {
-            return; // 数据长度不足1帧
+    if (!m_rxBatch.isEmpty()) {
+        qint64 nowNs = monotonicNowNs();
+        for (const RxFrame &item : m_rxBatch) {
+            m_rxDecodeLatency.add(item.decodeNs - item.readNs);
+            m_rxDispatchLatency.add(nowNs - item.decodeNs);
         }
         
-        if(ringbuf_get_at(cmd_rb, 0) == PROTOCOL_HEADER) {
-            cmd_len = PROTOCOL_LENGTH; // 使用固定包长
-            
-            if(rb_len < cmd_len) {
-                return; // 可能发生拆包，数据长度不足一帧
-            }
-            
-            if (ringbuf_get_at(cmd_rb, cmd_len - 1) == PROTOCOL_FOOTER) {
-                // 计算校验和（从包头到数据区结束，不包括包尾和校验字节）
-                // ringbuf_checksum返回16位累加和，取低8位作为校验和
-                uint16_t calc_checksum_full = ringbuf_checksum(cmd_rb, 0, cmd_len - 3);
-                uint8_t calc_checksum = (uint8_t)(calc_checksum_full & 0xFF);
-                uint8_t recv_checksum = ringbuf_get_at(cmd_rb, cmd_len - 2);
-                
-                if (calc_checksum == recv_checksum) {
-                    break; // 校验通过，跳出循环
-                } else {
-                    ringbuf_remove(cmd_rb, 1); // 校验失败，丢弃一个字节
-                    continue;
-                }
-            } else {
-                ringbuf_remove(cmd_rb, 1); // 包尾不匹配，丢弃一个字节
-                continue;
-            }
-        } else {
-            ringbuf_remove(cmd_rb, 1); // 丢弃一个字节，重新开始解析
-            continue;
+        // 整批交给批量消费者（如曲线），再逐帧分发给应答类消费者
+        emit framesReceived(m_rxBatch);
+        for (const RxFrame &item : m_rxBatch) {
+            dispatchFrame(item);
         }
     }
     
-    // 提取完整的数据包到临时缓冲区
-    for (int i = 0; i < PROTOCOL_LENGTH; i++) {
-        m_parseBuffer[i] = ringbuf_get_at(cmd_rb, i);
+    // v1帧（含应答）处理完后再发v2数据帧
+    if (!m_rxBlockBatch.isEmpty()) {
+        emit blocksReceived(m_rxBlockBatch);
     }
-    
+}
+
+void SerialCommunicationManager::dispatchFrame(const RxFrame &frame)
+{
     // 解析命令字并分发到不同模块
-    uint8_t cmd = m_parseBuffer[1]; // 命令字在第2个字节
+    uint8_t cmd = frame.data[1]; // 命令字在第2个字节
     
     switch (cmd) {
         case CMD_READ_DATA:
             {
-                uint8_t dataId = m_parseBuffer[2]; // 数据ID
+                uint8_t dataId = frame.data[2]; // 数据ID
                 uint32_t dataValue = 0;
                 // 从第3个字节开始提取4字节数据值（小端模式）
-                dataValue |= m_parseBuffer[3];
-                dataValue |= (m_parseBuffer[4] << 8);
-                dataValue |= (m_parseBuffer[5] << 16);
-                dataValue |= (m_parseBuffer[6] << 24);
+                dataValue |= frame.data[3];
+                dataValue |= (frame.data[4] << 8);
+                dataValue |= (frame.data[5] << 16);
+                dataValue |= (frame.data[6] << 24);
                 emit cmdReadDataReceived(dataId, dataValue);
             }
             break;
             
         case CMD_WRITE_DATA:
             {
-                uint8_t dataId = m_parseBuffer[2]; // 数据ID
+                uint8_t dataId = frame.data[2]; // 数据ID
                 uint32_t dataValue = 0;
                 // 从第3个字节开始提取4字节数据值（小端模式）
-                dataValue |= m_parseBuffer[3];
-                dataValue |= (m_parseBuffer[4] << 8);
-                dataValue |= (m_parseBuffer[5] << 16);
-                dataValue |= (m_parseBuffer[6] << 24);
+                dataValue |= frame.data[3];
+                dataValue |= (frame.data[4] << 8);
+                dataValue |= (frame.data[5] << 16);
+                dataValue |= (frame.data[6] << 24);
                 emit cmdWriteDataReceived(dataId, dataValue);
             }
             break;
             
         case CMD_MOTOR_START:
             {
-                uint8_t status = m_parseBuffer[2]; // 状态
-                uint8_t state = m_parseBuffer[3];  // 电机状态
+                uint8_t status = frame.data[2]; // 状态
+                uint8_t state = frame.data[3];  // 电机状态
                 emit cmdMotorStartReceived(status, state);
             }
             break;
             
         case CMD_MOTOR_STOP:
             {
-                uint8_t status = m_parseBuffer[2]; // 状态
-                uint8_t state = m_parseBuffer[3];  // 电机状态
+                uint8_t status = frame.data[2]; // 状态
+                uint8_t state = frame.data[3];  // 电机状态
                 emit cmdMotorStopReceived(status, state);
             }
             break;
             
         case CMD_MOTOR_CALIBRATE:
             {
-                uint8_t status = m_parseBuffer[2]; // 状态
-                uint8_t state = m_parseBuffer[3];  // 电机状态
+                uint8_t status = frame.data[2]; // 状态
+                uint8_t state = frame.data[3];  // 电机状态
                 emit cmdMotorCalibrateReceived(status, state);
             }
             break;
             
         case CMD_MODE_SET:
             {
-                uint8_t mode = m_parseBuffer[2]; // 模式
+                uint8_t mode = frame.data[2]; // 模式
                 emit cmdModeSetReceived(mode);
             }
             break;
             
+        case CMD_STATUS_REPORT:
+            // 状态查询应答（电流/速度/位置）目前没有使用方
+            break;
+            
+        case CMD_STATUS_SUBSCRIBE:
+            // 主动上报的数据由曲线按批处理，这里只分发订阅应答
+            if (!ProtocolDecoder::isStatusStream(frame.data)) {
+                uint8_t op = frame.data[2];     // 子命令
+                uint8_t status = frame.data[3]; // 状态
+                uint8_t count = frame.data[4];  // 已订阅个数
+                emit cmdStatusSubscribeReceived(op, status, count);
+            }
+            break;
+            
+        case CMD_PROTOCOL_NEGOTIATE:
+            // 版本切换已在I/O线程完成，这里无需分发
+            break;
+            
+        case CMD_BURST_CAPTURE:
+            // 突发捕获的应答和数据块由BurstCaptureManager按批处理
+            break;
+            
         default:
             qDebug() << "收到未知命令字:" << QString("0x%1").arg(cmd, 2, 16, QChar('0'));
             break;
     }
-    
-    // 移除已处理的数据包
-    ringbuf_remove(cmd_rb, PROTOCOL_LENGTH);
-}
\ No newline at end of file
+}
+
+bool SerialCommunicationManager::startRecording(const QString &path)
+{
+    QString filePath = path;
+    if (filePath.isEmpty()) {
+        QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/FOC_Recordings";
+        QDir().mkpath(dir);
+        filePath = QString("%1/session_%2.focrec")
+                       .arg(dir, QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    }
+
+    QString error = m_recorder->start(filePath, m_portName, m_baudRate);
+    emit recordingChanged();
+    emit recordingStatsChanged();
+    if (!error.isEmpty()) {
+        emit errorOccurred(error);
+        return false;
+    }
+    return true;
+}
+
+void SerialCommunicationManager::stopRecording()
+{
+    // 写出剩余数据后关闭文件；录制因写盘失败已停止时只需回收写文件线程
+    m_recorder->stop();
+    emit recordingChanged();
+    emit recordingStatsChanged();
+}
+
+bool SerialCommunicationManager::startReplay(const QString &path, double speed)
+{
+    if (path.isEmpty()) {
+        emit errorOccurred("未指定回放文件");
+        return false;
+    }
+
+    setReplaySpeed(speed);
+    m_lastReplayBytes = 0;
+    m_replayBytesPerSecond = 0.0;
+    m_replayFramesPerSecond = 0.0;
+    // 波特率以录制文件头为准，文件未记录时按115200推算发送节拍
+    bool ok = connectPort(QString(ReplayDevice::PORT_PREFIX) + path, 115200);
+    emit replayStatsChanged();
+    return ok;
+}
+
+void SerialCommunicationManager::setReplaySpeed(double speed)
+{
+    if (m_replaySpeed == speed) {
+        return;
+    }
+    m_replaySpeed = speed;
+    QMetaObject::invokeMethod(m_ioWorker, [this, speed]() {
+        m_ioWorker->setReplaySpeed(speed);
+    }, Qt::QueuedConnection);
+    emit replaySpeedChanged();
+}
+
+void SerialCommunicationManager::seekReplay(double seconds)
+{
+    if (!isReplaying()) {
+        return;
+    }
+    qint64 offsetNs = qint64(qMax(0.0, seconds) * 1e9);
+    QMetaObject::invokeMethod(m_ioWorker, [this, offsetNs]() {
+        m_ioWorker->seekReplay(offsetNs);
+    }, Qt::QueuedConnection);
+}
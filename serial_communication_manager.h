@@ -9,11 +9,14 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QThread>
-#include <QMutex>
-#include <QWaitCondition>
+#include <QVector>
 
-// 包含电机协议头文件和环形缓冲区
-#include "ringbuf.h"
+// 包含电机协议头文件和串口I/O线程
+#include "serial_io_worker.h"
+#include "alloc_counter.h"
+#include "traffic_log_model.h"
+#include "session_recorder.h"
+#include "replay_device.h"
 extern "C" {
 #include "DOC/motor_protocol.h"
 }
@@ -38,12 +41,79 @@ public:
     Q_PROPERTY(QStringList availablePorts READ availablePorts NOTIFY availablePortsChanged)
     Q_PROPERTY(QStringList availablePortDetails READ availablePortDetails NOTIFY availablePortDetailsChanged)
     Q_PROPERTY(QString connectionStatus READ connectionStatus NOTIFY connectionStatusChanged)
-    Q_PROPERTY(QString displayData READ displayData NOTIFY displayDataChanged)
+    Q_PROPERTY(TrafficLogModel *trafficLog READ trafficLog CONSTANT)
     Q_PROPERTY(bool showTx READ showTx WRITE setShowTx NOTIFY showTxChanged)
     Q_PROPERTY(bool showRx READ showRx WRITE setShowRx NOTIFY showRxChanged)
     Q_PROPERTY(bool hexDisplay READ hexDisplay WRITE setHexDisplay NOTIFY hexDisplayChanged)
     Q_PROPERTY(qint64 bytesReceived READ bytesReceived NOTIFY bytesReceivedChanged)
     Q_PROPERTY(qint64 bytesSent READ bytesSent NOTIFY bytesSentChanged)
+    
+    // 接收各级延迟（微秒）：读出->解包完成、解包完成->GUI分发
+    Q_PROPERTY(double rxDecodeLatencyUs READ rxDecodeLatencyUs NOTIFY rxLatencyChanged)
+    Q_PROPERTY(double rxDispatchLatencyUs READ rxDispatchLatencyUs NOTIFY rxLatencyChanged)
+    Q_PROPERTY(double rxDispatchLatencyMaxUs READ rxDispatchLatencyMaxUs NOTIFY rxLatencyChanged)
+    
+    // 每次串口唤醒平均/最多解出的帧数
+    Q_PROPERTY(double framesPerWakeup READ framesPerWakeup NOTIFY rxLatencyChanged)
+    Q_PROPERTY(int maxFramesPerWakeup READ maxFramesPerWakeup NOTIFY rxLatencyChanged)
+    
+    // 接收环形缓冲区：容量、高水位、溢出丢弃字节数
+    Q_PROPERTY(qint64 rxRingCapacity READ rxRingCapacity CONSTANT)
+    Q_PROPERTY(qint64 rxRingHighWater READ rxRingHighWater NOTIFY rxLatencyChanged)
+    Q_PROPERTY(qint64 rxRingDropped READ rxRingDropped NOTIFY rxLatencyChanged)
+    
+    // 协议版本（1：仅14字节帧；2：批量数据使用v2变长帧）与v2帧统计：已解出帧数、丢帧次数、CRC错误数
+    Q_PROPERTY(int protocolVersion READ protocolVersion NOTIFY rxLatencyChanged)
+    Q_PROPERTY(qint64 rxV2Blocks READ rxV2Blocks NOTIFY rxLatencyChanged)
+    Q_PROPERTY(qint64 rxV2SeqGaps READ rxV2SeqGaps NOTIFY rxLatencyChanged)
+    Q_PROPERTY(qint64 rxV2CrcErrors READ rxV2CrcErrors NOTIFY rxLatencyChanged)
+    
+    // 请求/应答事务引擎：在途窗口、应答超时、重发次数
+    Q_PROPERTY(int txWindow READ txWindow WRITE setTxWindow NOTIFY txConfigChanged)
+    Q_PROPERTY(int requestTimeoutMs READ requestTimeoutMs WRITE setRequestTimeoutMs NOTIFY txConfigChanged)
+    Q_PROPERTY(int maxRetries READ maxRetries WRITE setMaxRetries NOTIFY txConfigChanged)
+    Q_PROPERTY(int txByteBudget READ txByteBudget WRITE setTxByteBudget NOTIFY txConfigChanged)
+    
+    // 事务统计：每秒完成数、往返时间（微秒）、在途数、累计重发/超时放弃数
+    Q_PROPERTY(double transactionsPerSecond READ transactionsPerSecond NOTIFY txStatsChanged)
+    Q_PROPERTY(double requestRttUs READ requestRttUs NOTIFY txStatsChanged)
+    Q_PROPERTY(double requestRttMaxUs READ requestRttMaxUs NOTIFY txStatsChanged)
+    Q_PROPERTY(int txInFlight READ txInFlight NOTIFY txStatsChanged)
+    Q_PROPERTY(qint64 txRetries READ txRetries NOTIFY txStatsChanged)
+    Q_PROPERTY(qint64 txTimeouts READ txTimeouts NOTIFY txStatsChanged)
+    
+    // 写合并统计：平均每次写调用的命令帧数与字节数
+    Q_PROPERTY(double framesPerWrite READ framesPerWrite NOTIFY txStatsChanged)
+    Q_PROPERTY(double bytesPerWrite READ bytesPerWrite NOTIFY txStatsChanged)
+    
+    // 安全类命令（停机）入队->写入串口延迟（微秒）：最近一次、历史最大
+    Q_PROPERTY(double safetyLatencyUs READ safetyLatencyUs NOTIFY txStatsChanged)
+    Q_PROPERTY(double safetyLatencyMaxUs READ safetyLatencyMaxUs NOTIFY txStatsChanged)
+    
+    // 命令队列：长度上限、当前长度、最早一条排队时长（毫秒）、累计合并/丢弃数
+    Q_PROPERTY(int cmdQueueLimit READ cmdQueueLimit WRITE setCmdQueueLimit NOTIFY txConfigChanged)
+    Q_PROPERTY(int cmdQueueDepth READ cmdQueueDepth NOTIFY cmdQueueChanged)
+    Q_PROPERTY(double cmdQueueOldestAgeMs READ cmdQueueOldestAgeMs NOTIFY cmdQueueChanged)
+    Q_PROPERTY(qint64 cmdCoalesced READ cmdCoalesced NOTIFY cmdQueueChanged)
+    Q_PROPERTY(qint64 cmdDropped READ cmdDropped NOTIFY cmdQueueChanged)
+    
+    // 发送路径（入队、合并写入、应答匹配）累计堆分配次数，稳态下应保持不变；未打开FOC_COUNT_ALLOCATIONS时为-1（不可用）
+    Q_PROPERTY(qint64 txPathAllocations READ txPathAllocations NOTIFY cmdQueueChanged)
+    
+    // 会话录制：是否在录制、文件路径、已写入字节数、因写盘跟不上丢弃的字节数
+    Q_PROPERTY(bool isRecording READ isRecording NOTIFY recordingChanged)
+    Q_PROPERTY(QString recordingPath READ recordingPath NOTIFY recordingChanged)
+    Q_PROPERTY(qint64 recordedBytes READ recordedBytes NOTIFY recordingStatsChanged)
+    Q_PROPERTY(qint64 recordingDroppedBytes READ recordingDroppedBytes NOTIFY recordingStatsChanged)
+
+    // 会话回放：是否在回放、速度（1为实时，N为N倍速，0为尽快）、位置与时长（秒）、是否已放完、回放吞吐
+    Q_PROPERTY(bool isReplaying READ isReplaying NOTIFY connectionStateChanged)
+    Q_PROPERTY(double replaySpeed READ replaySpeed WRITE setReplaySpeed NOTIFY replaySpeedChanged)
+    Q_PROPERTY(double replayPositionSec READ replayPositionSec NOTIFY replayStatsChanged)
+    Q_PROPERTY(double replayDurationSec READ replayDurationSec NOTIFY replayStatsChanged)
+    Q_PROPERTY(bool replayFinished READ replayFinished NOTIFY replayStatsChanged)
+    Q_PROPERTY(double replayBytesPerSecond READ replayBytesPerSecond NOTIFY replayStatsChanged)
+    Q_PROPERTY(double replayFramesPerSecond READ replayFramesPerSecond NOTIFY replayStatsChanged)
 
 public:
 private:
@@ -58,36 +128,118 @@ public:
     QStringList availablePorts() const { return m_availablePorts; }
     QStringList availablePortDetails() const { return m_availablePortDetails; }
     QString connectionStatus() const { return m_connectionStatus; }
-    QString displayData() const { return m_displayData; }
+    TrafficLogModel *trafficLog() const { return m_trafficLog; }
     bool showTx() const { return m_showTx; }
     bool showRx() const { return m_showRx; }
     bool hexDisplay() const { return m_hexDisplay; }
     qint64 bytesReceived() const { return m_bytesReceived; }
     qint64 bytesSent() const { return m_bytesSent; }
+    double rxDecodeLatencyUs() const { return m_rxDecodeLatencyUs; }
+    double rxDispatchLatencyUs() const { return m_rxDispatchLatencyUs; }
+    double rxDispatchLatencyMaxUs() const { return m_rxDispatchLatencyMaxUs; }
+    double framesPerWakeup() const { return m_framesPerWakeup; }
+    int maxFramesPerWakeup() const { return m_maxFramesPerWakeup; }
+    qint64 rxRingCapacity() const { return m_ioWorker->rxRingCapacity(); }
+    qint64 rxRingHighWater() const { return m_ioWorker->rxRingHighWater(); }
+    qint64 rxRingDropped() const { return m_ioWorker->rxRingDropped(); }
+    int protocolVersion() const { return m_ioWorker->protocolVersion(); }
+    qint64 rxV2Blocks() const { return m_ioWorker->rxV2Blocks(); }
+    qint64 rxV2SeqGaps() const { return m_ioWorker->rxV2SeqGaps(); }
+    qint64 rxV2CrcErrors() const { return m_ioWorker->rxV2CrcErrors(); }
+    int txWindow() const { return m_ioWorker->txWindow(); }
+    int requestTimeoutMs() const { return m_ioWorker->requestTimeoutMs(); }
+    int maxRetries() const { return m_ioWorker->maxRetries(); }
+    int txByteBudget() const { return m_ioWorker->txByteBudget(); }
+    double framesPerWrite() const { return m_framesPerWrite; }
+    double bytesPerWrite() const { return m_bytesPerWrite; }
+    double transactionsPerSecond() const { return m_transactionsPerSecond; }
+    double requestRttUs() const { return m_requestRttUs; }
+    double requestRttMaxUs() const { return m_requestRttMaxUs; }
+    int txInFlight() const { return m_ioWorker->txInFlight(); }
+    qint64 txRetries() const { return m_ioWorker->txRetries(); }
+    qint64 txTimeouts() const { return m_ioWorker->txTimeouts(); }
+    double safetyLatencyUs() const { return m_ioWorker->safetyLatencyNs() / 1000.0; }
+    double safetyLatencyMaxUs() const { return m_ioWorker->safetyLatencyMaxNs() / 1000.0; }
+    int cmdQueueLimit() const { return m_ioWorker->cmdQueueLimit(); }
+    int cmdQueueDepth() const { return m_cmdQueueDepth; }
+    double cmdQueueOldestAgeMs() const { return m_cmdQueueOldestAgeMs; }
+    qint64 cmdCoalesced() const { return m_ioWorker->cmdCoalesced(); }
+    qint64 cmdDropped() const { return m_ioWorker->cmdDropped(); }
+    qint64 txPathAllocations() const { return AllocCounter::total(); }
+    bool isRecording() const { return m_recorder->isRecording(); }
+    QString recordingPath() const { return m_recorder->path(); }
+    qint64 recordedBytes() const { return m_recorder->bytesWritten(); }
+    qint64 recordingDroppedBytes() const { return m_recorder->droppedBytes(); }
+    bool isReplaying() const { return m_isConnected && m_portName.startsWith(QLatin1String(ReplayDevice::PORT_PREFIX)); }
+    double replaySpeed() const { return m_replaySpeed; }
+    double replayPositionSec() const { return m_ioWorker->replayPositionNs() / 1e9; }
+    double replayDurationSec() const { return m_ioWorker->replayDurationNs() / 1e9; }
+    bool replayFinished() const { return m_ioWorker->replayFinished(); }
+    double replayBytesPerSecond() const { return m_replayBytesPerSecond; }
+    double replayFramesPerSecond() const { return m_replayFramesPerSecond; }
 
 public slots:
     // Setter方法 - QML设置属性
     void setShowTx(bool show) { 
         if (m_showTx != show) {
             m_showTx = show; 
+            m_ioWorker->setTxTapEnabled(show); // 不显示发送数据时I/O线程不再复制已写出的命令
             emit showTxChanged();
-            updateDisplayData();
         }
     }
     
     void setShowRx(bool show) { 
         if (m_showRx != show) {
             m_showRx = show; 
+            m_ioWorker->setRawTapEnabled(show); // 不显示接收数据时I/O线程不再复制原始数据
             emit showRxChanged();
-            updateDisplayData();
         }
     }
     
+    void setTxWindow(int window) {
+        if (window != txWindow()) {
+            m_ioWorker->setTxWindow(window);
+            emit txConfigChanged();
+            // 窗口扩大后立即补发
+            QMetaObject::invokeMethod(m_ioWorker, "processCmdQueue", Qt::QueuedConnection);
+        }
+    }
+    
+    void setRequestTimeoutMs(int ms) {
+        if (ms != requestTimeoutMs()) {
+            m_ioWorker->setRequestTimeoutMs(ms);
+            emit txConfigChanged();
+        }
+    }
+    
+    void setMaxRetries(int retries) {
+        if (retries != maxRetries()) {
+            m_ioWorker->setMaxRetries(retries);
+            emit txConfigChanged();
+        }
+    }
+    
+    void setTxByteBudget(int bytes) {
+        if (bytes != txByteBudget()) {
+            m_ioWorker->setTxByteBudget(bytes);
+            emit txConfigChanged();
+        }
+    }
+    
+    void setCmdQueueLimit(int limit) {
+        if (limit != cmdQueueLimit()) {
+            m_ioWorker->setCmdQueueLimit(limit);
+            emit txConfigChanged();
+        }
+    }
+    
+    void setReplaySpeed(double speed);
+    
     void setHexDisplay(bool hex) { 
         if (m_hexDisplay != hex) {
             m_hexDisplay = hex; 
             emit hexDisplayChanged();
-            updateDisplayData();
+            m_trafficLog->setHexDisplay(hex);
         }
     }
     
@@ -98,7 +250,14 @@ public slots:
     Q_INVOKABLE void clearData();
     Q_INVOKABLE void refreshPorts();
     Q_INVOKABLE void resetByteCounters();
-    Q_INVOKABLE bool pushCmd(const QByteArray &data, motor_command_t cmd); // 推送命令到队列，自动添加包头包尾和校验和
+    Q_INVOKABLE bool pushCmd(const QByteArray &data, motor_command_t cmd, int priority = -1); // 推送命令到队列，自动添加包头包尾和校验和，priority为TxPriority，默认按命令字确定
+    bool pushFrame(const ProtocolFrame &frame, int priority = -1); // 推送已编码的命令帧（ProtocolEncoder），不分配内存
+    bool pushFrames(const ProtocolFrame *frames, int count, int priority = -1, bool reportFull = true); // 推送一组已编码的命令帧，整组一次入队；reportFull为false时队列满只返回false，不发errorOccurred
+    Q_INVOKABLE bool requestProtocolVersion(int version, int maxBlockMs = 20); // 协商协议版本，应答到达后生效（见protocolVersion）
+    Q_INVOKABLE bool startRecording(const QString &path = QString()); // 开始录制全部收发数据，path为空时存到文档目录下FOC_Recordings
+    Q_INVOKABLE void stopRecording();
+    Q_INVOKABLE bool startReplay(const QString &path, double speed = 1.0); // 回放录制文件，代替串口送入接收数据
+    Q_INVOKABLE void seekReplay(double seconds); // 定位到相对录制开始seconds秒处
 
 signals:
     // 属性变化通知
@@ -106,18 +265,31 @@ signals:
     void availablePortsChanged();
     void availablePortDetailsChanged();
     void connectionStatusChanged();
-    void displayDataChanged();
     void showTxChanged();
     void showRxChanged();
     void hexDisplayChanged();
     void bytesReceivedChanged();
     void bytesSentChanged();
+    void rxLatencyChanged();
+    void txConfigChanged();
+    void txStatsChanged();
+    void cmdQueueChanged();
+    void recordingChanged();
+    void recordingStatsChanged();
+    void replaySpeedChanged();
+    void replayStatsChanged();
     
     // 数据更新信号
     void dataReceived(const QString &data, const QString &timestamp);
     void dataSent(const QString &data, const QString &timestamp);
     void errorOccurred(const QString &error);
     
+    // 批量帧信号：每次取帧只发射一次，携带本批全部已解析的协议帧
+    void framesReceived(const QVector<RxFrame> &frames);
+    
+    // v2批量数据帧信号：与framesReceived同批发射，在framesReceived及逐帧分发之后
+    void blocksReceived(const QVector<RxBlock> &blocks);
+    
     // 协议命令分发信号
     void cmdReadDataReceived(uint8_t dataId, uint32_t dataValue);
     void cmdWriteDataReceived(uint8_t dataId, uint32_t dataValue);
@@ -125,21 +297,23 @@ signals:
     void cmdMotorStopReceived(uint8_t status, uint8_t state);
     void cmdMotorCalibrateReceived(uint8_t status, uint8_t state);
     void cmdModeSetReceived(uint8_t mode);
+    void cmdStatusSubscribeReceived(uint8_t op, uint8_t status, uint8_t subscribedCount); // 状态订阅应答（主动上报帧随framesReceived批量到达）
 
 private slots:
-    void onReadyRead();
-    void onErrorOccurred(QSerialPort::SerialPortError error);
+    void onDataRead(const QByteArray &data, qint64 timestampNs);
+    void onDataWritten(const QByteArray &data, qint64 timestampNs);
+    void onPortErrorOccurred(const QString &error);
+    void onFramesReady(); // 从I/O线程取出已解析的协议帧
     void updateAvailablePorts();
-    void processCmdQueue(); // 处理命令队列
-    void parseProtocol(); // 协议解包函数
 
 private:
-    QSerialPort *m_serialPort;
+    // 串口I/O线程
+    QThread *m_ioThread;
+    SerialIoWorker *m_ioWorker;
     bool m_isConnected;
     QString m_connectionStatus;
     QStringList m_availablePorts;
     QStringList m_availablePortDetails;
-    QString m_displayData;
     
     // 显示设置
     bool m_showTx;
@@ -148,34 +322,54 @@ private:
     
     // 字节计数
     qint64 m_bytesReceived;
+    qint64 m_bytesReceivedBase; // 清零时I/O线程累计接收字节数
     qint64 m_bytesSent;
+    qint64 m_bytesSentBase;     // 清零时I/O线程累计发送字节数
+    
+    // 收发记录（列表模型，显示帧节拍批量插入）
+    TrafficLogModel *m_trafficLog;
+    
+    // 会话录制（I/O线程直接写入其块缓冲）与当前连接参数（写入录制文件头）
+    SessionRecorder *m_recorder;
+    QString m_portName;
+    int m_baudRate;
+    
+    // 会话回放（每次刷新计数时结算吞吐）
+    double m_replaySpeed;
+    qint64 m_lastReplayBytes;
+    double m_replayBytesPerSecond;
+    double m_replayFramesPerSecond;
+    
+    // 接收延迟统计（每次刷新计数时结算）
+    LatencyStat m_rxDecodeLatency;
+    LatencyStat m_rxDispatchLatency;
+    double m_rxDecodeLatencyUs;
+    double m_rxDispatchLatencyUs;
+    double m_rxDispatchLatencyMaxUs;
+    double m_framesPerWakeup;
+    int m_maxFramesPerWakeup;
+    
+    // 事务统计（每次刷新计数时结算）
+    double m_transactionsPerSecond;
+    double m_requestRttUs;
+    double m_requestRttMaxUs;
+    qint64 m_lastTxStatsNs;
+    double m_framesPerWrite;
+    double m_bytesPerWrite;
+    
+    // 命令队列状态（每次刷新计数时读取）
+    int m_cmdQueueDepth;
+    double m_cmdQueueOldestAgeMs;
     
-    // 数据存储
-    struct DataItem {
-        QString data;
-        QString timestamp;
-        bool isTx;
-    };
-    QList<DataItem> m_dataList;
-    static const int MAX_LINES = 1000;
-    
-    // 命令队列 - 每条命令14字节
-    QList<QByteArray> m_cmdList;
-    QMutex m_cmdMutex; // 命令队列互斥锁
-    QWaitCondition m_cmdCondition; // 命令队列条件变量
-    bool m_stopCmdThread; // 停止命令线程标志
-    
-    // 协议接收缓冲区
-    ringbuf_t *m_rxRingbuf; // 接收环形缓冲区
-    uint8_t m_parseBuffer[PROTOCOL_LENGTH]; // 协议解析临时缓冲区
+    // 批量取帧缓冲（复用容量，避免每批分配）
+    QVector<RxFrame> m_rxBatch;
+    QVector<RxBlock> m_rxBlockBatch;
     
     // 内部方法
     void scanAvailablePorts();
+    void dispatchFrame(const RxFrame &frame); // 按命令字分发协议帧
     QString formatData(const QByteArray &data, bool isTx);
     QByteArray parseInputString(const QString &input);
-    void appendToDataList(const QString &data, bool isTx);
-    void updateDisplayData();
-    QString byteArrayToHex(const QByteArray &data);
     
     // 定时器
     QTimer *m_updateTimer;
@@ -0,0 +1,937 @@
+#include "serial_io_worker.h"
+#include "alloc_counter.h"
+#include "simulated_device.h"
+#include "session_recorder.h"
+#include "replay_device.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <cstring>
+
+// 链路允许提前写入的数据量（按传输时间计），避免每帧都等待定时器
+static const qint64 TX_BACKLOG_NS = 2000000;
+
+// 8N1：每字节在链路上占10位
+static const int BITS_PER_BYTE = 10;
+
+// 安全类命令唤醒事件：以Qt::HighEventPriority投递，排在已排队的普通事件之前
+static const QEvent::Type SAFETY_WAKE_EVENT = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+TxPriority defaultTxPriority(uint8_t cmd)
+{
+    switch (cmd) {
+        case CMD_MOTOR_STOP:
+            return TX_PRIORITY_SAFETY;
+        case CMD_MOTOR_START:
+        case CMD_TORQUE_CONTROL:
+        case CMD_SPEED_CONTROL:
+        case CMD_POSITION_CONTROL:
+        case CMD_MOTION_CONTROL:
+            return TX_PRIORITY_CONTROL;
+        case CMD_READ_DATA:
+        case CMD_STATUS_REPORT:
+        case CMD_STATUS_SUBSCRIBE:
+            return TX_PRIORITY_TELEMETRY;
+        default:
+            return TX_PRIORITY_PARAM; // 写数据、模式/接口/CANID/零位设置、校准
+    }
+}
+
+// 读/写数据应答需要同时匹配数据ID，状态订阅应答需要匹配子命令（主动上报包字节2为数据ID，不会匹配），
+// 其他命令只匹配命令字（状态查询应答的命令字不与主动上报共用）
+static bool responseMatches(const ProtocolFrame &request, const uint8_t *response)
+{
+    uint8_t cmd = request[1];
+    if (cmd != response[1]) {
+        return false;
+    }
+    if (cmd == CMD_READ_DATA || cmd == CMD_WRITE_DATA) {
+        return request[2] == response[2];
+    }
+    if (cmd == CMD_STATUS_SUBSCRIBE) {
+        return request[2] == response[2];
+    }
+    if (cmd == CMD_BURST_CAPTURE) {
+        return request[2] == response[2]; // 按子命令匹配；分块读取由第一个到达的数据块应答
+    }
+    return true;
+}
+
+SerialIoWorker::SerialIoWorker(uint32_t rxRingSize, QObject *parent)
+    : QObject(parent)
+    , m_serialPort(new QSerialPort(this))
+    , m_simDevice(new SimulatedDevice(this))
+    , m_replayDevice(new ReplayDevice(this))
+    , m_device(m_serialPort)
+    , m_cmdTimer(new QTimer(this))
+    , m_timeoutTimer(new QTimer(this))
+    , m_frameWireNs(0)
+    , m_byteWireNs(0)
+    , m_linkBusyUntilNs(0)
+    , m_cmdQueued(0)
+    , m_cmdQueueLimit(DEFAULT_CMD_QUEUE_LIMIT)
+    , m_cmdCoalesced(0)
+    , m_cmdDropped(0)
+    , m_cmdScheduled(false)
+    , m_txWindow(DEFAULT_TX_WINDOW)
+    , m_requestTimeoutMs(DEFAULT_REQUEST_TIMEOUT_MS)
+    , m_maxRetries(DEFAULT_MAX_RETRIES)
+    , m_txInFlight(0)
+    , m_txTimeouts(0)
+    , m_timeoutLogged(false)
+    , m_txRetries(0)
+    , m_txCompleted(0)
+    , m_txRttSumNs(0)
+    , m_txRttMaxNs(0)
+    , m_safetyLatencyNs(0)
+    , m_safetyLatencyMaxNs(0)
+    , m_txBatchSize(0)
+    , m_txByteBudget(DEFAULT_TX_BYTE_BUDGET)
+    , m_txTapEnabled(true)
+    , m_totalBytesWritten(0)
+    , m_txWrites(0)
+    , m_txWriteFrames(0)
+    , m_txWriteBytes(0)
+    , m_rxRingbuf(nullptr)
+    , m_rawTapEnabled(true)
+    , m_totalBytesRead(0)
+    , m_recorder(nullptr)
+    , m_framesNotifyPending(false)
+    , m_droppedFrames(0)
+    , m_prevReadNs(0)
+    , m_lastRxArrivalNs(0)
+    , m_protocolVersion(1)
+    , m_rxV2NextSeq(0)
+    , m_rxV2SeqValid(false)
+    , m_rxV2Blocks(0)
+    , m_rxV2SeqGaps(0)
+    , m_rxV2CrcErrors(0)
+    , m_droppedBlocks(0)
+    , m_rxWakeups(0)
+    , m_rxWakeupFrames(0)
+    , m_maxFramesPerWakeup(0)
+{
+    // 子对象随本对象一起移动到I/O线程
+    connect(m_serialPort, &QSerialPort::readyRead, this, &SerialIoWorker::onReadyRead);
+    connect(m_serialPort, &QSerialPort::errorOccurred, this, &SerialIoWorker::onErrorOccurred);
+    connect(m_simDevice, &QIODevice::readyRead, this, &SerialIoWorker::onReadyRead);
+    connect(m_replayDevice, &QIODevice::readyRead, this, &SerialIoWorker::onReadyRead);
+
+    // 尽快回放：GUI取帧跟不上时暂缓送数，不因队列满丢帧
+    m_replayDevice->setReadyCheck([this]() {
+        return m_rxFrames.size() < m_rxFrames.capacity() / 2 && m_rxBlocks.size() < m_rxBlocks.capacity() / 2;
+    });
+
+    m_cmdTimer->setSingleShot(true);
+    m_cmdTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_cmdTimer, &QTimer::timeout, this, &SerialIoWorker::processCmdQueue);
+
+    m_timeoutTimer->setSingleShot(true);
+    m_timeoutTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &SerialIoWorker::onRequestTimeout);
+
+    // 初始化协议接收环形缓冲区
+    m_rxRingbuf = ringbuf_alloc(rxRingSize);
+    if (!m_rxRingbuf) {
+        qWarning() << "接收缓冲区容量必须是2的幂:" << rxRingSize << "，使用默认容量";
+        m_rxRingbuf = ringbuf_alloc(DEFAULT_RX_RING_SIZE);
+    }
+}
+
+SerialIoWorker::~SerialIoWorker()
+{
+    // 释放协议接收环形缓冲区
+    if (m_rxRingbuf) {
+        ringbuf_free(m_rxRingbuf);
+        m_rxRingbuf = nullptr;
+    }
+}
+
+QString SerialIoWorker::openPort(const QString &portName, int baudRate)
+{
+    if (m_device->isOpen()) {
+        closePort();
+    }
+
+    if (portName == QLatin1String(SimulatedDevice::PORT_NAME)) {
+        // 模拟电机：不经过串口驱动，按协议在本线程内应答
+        m_device = m_simDevice;
+    } else if (portName.startsWith(QLatin1String(ReplayDevice::PORT_PREFIX))) {
+        // 会话回放：录制文件中的接收数据按原时间间隔送入
+        m_device = m_replayDevice;
+        m_replayDevice->setFileName(portName.mid(int(strlen(ReplayDevice::PORT_PREFIX))));
+    } else {
+        m_device = m_serialPort;
+        m_serialPort->setPortName(portName);
+        m_serialPort->setBaudRate(baudRate);
+        m_serialPort->setDataBits(QSerialPort::Data8);
+        m_serialPort->setParity(QSerialPort::NoParity);
+        m_serialPort->setStopBits(QSerialPort::OneStop);
+        m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    }
+
+    if (!m_device->open(QIODevice::ReadWrite)) {
+        return m_device->errorString();
+    }
+
+    if (m_rxRingbuf) {
+        ringbuf_clear(m_rxRingbuf);
+    }
+
+    // 回放按录制时的波特率推算
+    if (m_device == m_replayDevice && m_replayDevice->baudRate() > 0) {
+        baudRate = m_replayDevice->baudRate();
+    }
+
+    // 按波特率推算每帧传输时间，作为发送节拍
+    m_frameWireNs = qint64(PROTOCOL_LENGTH) * BITS_PER_BYTE * 1000000000LL / qMax(1, baudRate);
+    m_byteWireNs = qint64(BITS_PER_BYTE) * 1000000000LL / qMax(1, baudRate);
+    m_linkBusyUntilNs = 0;
+    m_prevReadNs = 0;
+    m_lastRxArrivalNs = 0;
+
+    // 串口已连接，处理连接前积压的命令
+    processCmdQueue();
+    return QString();
+}
+
+void SerialIoWorker::closePort()
+{
+    m_cmdTimer->stop();
+    m_timeoutTimer->stop();
+    // 在途请求随串口关闭作废，未发送的命令保留到下次连接
+    {
+        QMutexLocker locker(&m_cmdMutex);
+        while (!m_inflight.isEmpty()) {
+            m_txPool.release(m_txPool.popFront(m_inflight));
+        }
+    }
+    m_txInFlight.store(0, std::memory_order_relaxed);
+    m_timeoutLogged = false;
+    if (m_device->isOpen()) {
+        m_device->close();
+    }
+    // 重新连接的电机从v1开始，需要重新协商
+    m_protocolVersion.store(1, std::memory_order_relaxed);
+    m_rxV2SeqValid = false;
+}
+
+void SerialIoWorker::setReplaySpeed(double speed)
+{
+    m_replayDevice->setSpeed(speed);
+}
+
+void SerialIoWorker::seekReplay(qint64 offsetNs)
+{
+    if (m_device != m_replayDevice || !m_replayDevice->isOpen()) {
+        return;
+    }
+    // 已读出未解析的数据属于定位前的位置，一并丢弃
+    if (m_rxRingbuf) {
+        ringbuf_clear(m_rxRingbuf);
+    }
+    m_replayDevice->seekTime(offsetNs);
+}
+
+qint64 SerialIoWorker::replayDurationNs() const
+{
+    return m_replayDevice->durationNs();
+}
+
+qint64 SerialIoWorker::replayPositionNs() const
+{
+    return m_replayDevice->positionNs();
+}
+
+qint64 SerialIoWorker::replayBytes() const
+{
+    return m_replayDevice->bytesReplayed();
+}
+
+bool SerialIoWorker::replayFinished() const
+{
+    return m_replayDevice->finished();
+}
+
+void SerialIoWorker::writeRaw(const QByteArray &data)
+{
+    if (!m_device->isOpen()) {
+        emit errorOccurred("串口未连接");
+        return;
+    }
+
+    qint64 bytesWritten = m_device->write(data);
+    if (bytesWritten > 0) {
+        m_txWrites.fetch_add(1, std::memory_order_relaxed);
+        m_txWriteBytes.fetch_add(bytesWritten, std::memory_order_relaxed);
+        m_totalBytesWritten.fetch_add(bytesWritten, std::memory_order_relaxed);
+        qint64 now = monotonicNowNs();
+        if (m_recorder) {
+            m_recorder->append(true, now, data.constData(), int(bytesWritten));
+        }
+        emit dataWritten(data.left(bytesWritten), now);
+    } else {
+        emit errorOccurred("发送数据失败: " + m_device->errorString());
+    }
+}
+
+int SerialIoWorker::enqueueCmd(const ProtocolFrame &frame, int priority)
+{
+    return enqueueCmds(&frame, 1, priority);
+}
+
+int SerialIoWorker::enqueueCmds(const ProtocolFrame *frames, int count, int priority)
+{
+    AllocCounter::Scope countAllocations;
+
+    bool rejected = false;
+    bool wakeSafety = false;
+    bool wakeNormal = false;
+    int queueSize = 0;
+    {
+        // 整批命令只加一次锁、只唤醒一次
+        QMutexLocker locker(&m_cmdMutex);
+        qint64 now = monotonicNowNs();
+        for (int i = 0; i < count; ++i) {
+            int p = (priority < 0 || priority >= TX_PRIORITY_COUNT) ? defaultTxPriority(frames[i][1]) : priority;
+            if (!enqueueLocked(frames[i], p, now)) {
+                rejected = true;
+                continue;
+            }
+            if (p == TX_PRIORITY_SAFETY) {
+                wakeSafety = true;
+            } else {
+                wakeNormal = true;
+            }
+        }
+        queueSize = m_cmdQueued;
+    }
+
+    // 唤醒I/O线程需要投递事件（Qt内部分配），不计入
+    AllocCounter::Pause pause;
+    if (wakeSafety) {
+        // 安全类命令每次都单独唤醒，不与已投递的普通处理请求合并
+        QCoreApplication::postEvent(this, new QEvent(SAFETY_WAKE_EVENT), Qt::HighEventPriority);
+    }
+    if (wakeNormal && !m_cmdScheduled.exchange(true)) {
+        // 投递到I/O线程处理，已投递过则不重复唤醒
+        QMetaObject::invokeMethod(this, &SerialIoWorker::processCmdQueue, Qt::QueuedConnection);
+    }
+    return rejected ? -1 : queueSize;
+}
+
+bool SerialIoWorker::enqueueLocked(const ProtocolFrame &frame, int priority, qint64 now)
+{
+    bool isRead = priority == TX_PRIORITY_TELEMETRY && frame[1] == CMD_READ_DATA;
+    uint8_t dataId = frame[2];
+    TxPool::List &telemetry = m_cmdLanes[TX_PRIORITY_TELEMETRY];
+
+    // 同一数据ID的读请求还没发出：不重复排队，以最新请求为准
+    if (isRead && m_pendingReadIds.test(dataId)) {
+        for (int idx = telemetry.head; idx != TxPool::NIL; idx = m_txPool.next(idx)) {
+            Transaction &pending = m_txPool[idx];
+            if (pending.frame[1] == CMD_READ_DATA && pending.frame[2] == dataId) {
+                pending.frame = frame;
+                break;
+            }
+        }
+        m_cmdCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 队列已满：丢弃最早的周期读取腾出位置，没有可丢弃的周期读取时拒绝新命令
+    if (priority != TX_PRIORITY_SAFETY && m_cmdQueued >= m_cmdQueueLimit.load(std::memory_order_relaxed)) {
+        m_cmdDropped.fetch_add(1, std::memory_order_relaxed);
+        if (telemetry.isEmpty()) {
+            return false;
+        }
+        int victim = m_txPool.popFront(telemetry);
+        if (m_txPool[victim].frame[1] == CMD_READ_DATA) {
+            m_pendingReadIds.reset(m_txPool[victim].frame[2]);
+        }
+        m_txPool.release(victim);
+        --m_cmdQueued;
+    }
+
+    // 槽位数大于队列上限+在途窗口上限，只有安全类命令可能用尽槽位
+    int idx = m_txPool.acquire();
+    if (idx == TxPool::NIL) {
+        m_cmdDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Transaction &t = m_txPool[idx];
+    t.frame = frame;
+    t.enqueueNs = now;
+    t.txNs = 0;
+    t.priority = priority;
+    t.retries = 0;
+    m_txPool.pushBack(m_cmdLanes[priority], idx);
+    if (isRead) {
+        m_pendingReadIds.set(dataId);
+    }
+    ++m_cmdQueued;
+    return true;
+}
+
+void SerialIoWorker::cmdQueueStats(int &depth, qint64 &oldestAgeNs)
+{
+    QMutexLocker locker(&m_cmdMutex);
+    depth = m_cmdQueued;
+    oldestAgeNs = 0;
+
+    qint64 now = monotonicNowNs();
+    for (const TxPool::List &lane : m_cmdLanes) {
+        if (!lane.isEmpty()) {
+            oldestAgeNs = qMax(oldestAgeNs, now - m_txPool[lane.head].enqueueNs);
+        }
+    }
+}
+
+bool SerialIoWorker::event(QEvent *e)
+{
+    if (e->type() == SAFETY_WAKE_EVENT) {
+        if (m_device->isOpen()) {
+            sendSafetyCmds();
+        }
+        return true;
+    }
+    return QObject::event(e);
+}
+
+void SerialIoWorker::sendSafetyCmds()
+{
+    AllocCounter::Scope countAllocations;
+
+    m_txBatchSize = 0;
+    {
+        QMutexLocker locker(&m_cmdMutex);
+        TxPool::List &safety = m_cmdLanes[TX_PRIORITY_SAFETY];
+        while (!safety.isEmpty() && m_txBatchSize < MAX_TX_BATCH_FRAMES) {
+            m_txBatch[m_txBatchSize++] = m_txPool.popFront(safety);
+            --m_cmdQueued;
+        }
+    }
+    if (m_txBatchSize == 0) {
+        return;
+    }
+
+    // 不等待在途窗口和链路节拍，合并写入后立即flush
+    if (!writeBatch()) {
+        return;
+    }
+    if (m_device == m_replayDevice) {
+        return; // 回放时槽位已在写出后释放，不统计发送延迟
+    }
+    {
+        AllocCounter::Pause pause;
+        if (m_device == m_serialPort) {
+            m_serialPort->flush();
+        }
+    }
+
+    for (int i = 0; i < m_txBatchSize; ++i) {
+        const Transaction &t = m_txPool[m_txBatch[i]];
+        if (t.retries == 0) {
+            qint64 latencyNs = t.txNs - t.enqueueNs;
+            m_safetyLatencyNs.store(latencyNs, std::memory_order_relaxed);
+            if (latencyNs > m_safetyLatencyMaxNs.load(std::memory_order_relaxed)) {
+                m_safetyLatencyMaxNs.store(latencyNs, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void SerialIoWorker::processCmdQueue()
+{
+    m_cmdScheduled.store(false);
+
+    if (!m_device->isOpen()) {
+        return; // 串口未连接，命令保留在队列中，连接后再发送
+    }
+
+    sendSafetyCmds();
+
+    AllocCounter::Scope countAllocations;
+
+    // 在途请求未满窗口时按优先级取出命令，凑满字节预算后一次写入；
+    // 链路上积压的数据超过允许量时，等到链路空闲再发
+    int window = m_txWindow.load(std::memory_order_relaxed);
+    int budget = m_txByteBudget.load(std::memory_order_relaxed);
+    qint64 allowedNs = qMax(TX_BACKLOG_NS, m_frameWireNs);
+
+    forever {
+        m_txBatchSize = 0;
+        int batchBytes = 0;
+        bool budgetFull = false;
+        qint64 now = monotonicNowNs();
+        qint64 busyUntilNs = qMax(m_linkBusyUntilNs, now);
+
+        while (m_inflight.size + m_txBatchSize < window) {
+            if (batchBytes + PROTOCOL_LENGTH > budget) {
+                budgetFull = true;
+                break;
+            }
+            qint64 backlogNs = busyUntilNs - now;
+            if (backlogNs > allowedNs) {
+                if (!m_cmdTimer->isActive()) {
+                    AllocCounter::Pause pause;
+                    m_cmdTimer->start(int((backlogNs - allowedNs + 999999) / 1000000));
+                }
+                break;
+            }
+
+            QMutexLocker locker(&m_cmdMutex);
+            int lane = TX_PRIORITY_CONTROL;
+            while (lane < TX_PRIORITY_COUNT && m_cmdLanes[lane].isEmpty()) {
+                ++lane;
+            }
+            if (lane == TX_PRIORITY_COUNT) {
+                break;
+            }
+            int idx = m_txPool.popFront(m_cmdLanes[lane]);
+            --m_cmdQueued;
+            const ProtocolFrame &frame = m_txPool[idx].frame;
+            if (lane == TX_PRIORITY_TELEMETRY && frame[1] == CMD_READ_DATA) {
+                m_pendingReadIds.reset(frame[2]);
+            }
+            m_txBatch[m_txBatchSize++] = idx;
+            batchBytes += PROTOCOL_LENGTH;
+            busyUntilNs += m_frameWireNs;
+        }
+
+        if (m_txBatchSize == 0 || !writeBatch() || !budgetFull) {
+            return;
+        }
+    }
+}
+
+bool SerialIoWorker::writeBatch()
+{
+    char *out = m_txBuffer.data();
+    for (int i = 0; i < m_txBatchSize; ++i) {
+        memcpy(out + i * PROTOCOL_LENGTH, m_txPool[m_txBatch[i]].frame.data(), PROTOCOL_LENGTH);
+    }
+    qint64 batchBytes = qint64(m_txBatchSize) * PROTOCOL_LENGTH;
+
+    qint64 bytesWritten;
+    {
+        // QSerialPort内部写缓冲的分配不计入
+        AllocCounter::Pause pause;
+        bytesWritten = m_device->write(out, batchBytes);
+    }
+    if (bytesWritten <= 0) {
+        AllocCounter::Pause pause;
+        QString error = "发送命令失败: " + m_device->errorString();
+        emit errorOccurred(error);
+        qDebug() << error;
+        // 未写出的命令放回各自通道队首，保持原有顺序
+        for (int i = m_txBatchSize - 1; i >= 0; --i) {
+            requeueFront(m_txBatch[i]);
+        }
+        return false;
+    }
+
+    m_txWrites.fetch_add(1, std::memory_order_relaxed);
+    m_txWriteFrames.fetch_add(m_txBatchSize, std::memory_order_relaxed);
+    m_txWriteBytes.fetch_add(bytesWritten, std::memory_order_relaxed);
+    m_totalBytesWritten.fetch_add(bytesWritten, std::memory_order_relaxed);
+
+    // 累计链路占用时间：链路空闲时从当前时刻算起
+    qint64 now = monotonicNowNs();
+    m_linkBusyUntilNs = qMax(m_linkBusyUntilNs, now) + m_frameWireNs * m_txBatchSize;
+
+    // 会话录制：只拷入预分配的块缓冲，不分配
+    if (m_recorder) {
+        m_recorder->append(true, now, out, int(bytesWritten));
+    }
+
+    // 发送显示旁路：只在开启时复制一份
+    if (m_txTapEnabled.load(std::memory_order_relaxed)) {
+        AllocCounter::Pause pause;
+        emit dataWritten(QByteArray(out, int(batchBytes)), now);
+    }
+
+    // 回放时命令被设备丢弃、不会有应答：写出即完成，不占在途窗口也不计超时，
+    // 录制文件中的应答也就不会被当作本次请求的应答统计往返时间
+    if (m_device == m_replayDevice) {
+        QMutexLocker locker(&m_cmdMutex);
+        for (int i = 0; i < m_txBatchSize; ++i) {
+            m_txPool[m_txBatch[i]].txNs = now;
+            m_txPool.release(m_txBatch[i]);
+        }
+        return true;
+    }
+
+    for (int i = 0; i < m_txBatchSize; ++i) {
+        m_txPool[m_txBatch[i]].txNs = now;
+        m_txPool.pushBack(m_inflight, m_txBatch[i]);
+    }
+    m_txInFlight.store(m_inflight.size, std::memory_order_relaxed);
+    if (!m_timeoutTimer->isActive()) {
+        AllocCounter::Pause pause;
+        armTimeoutTimer();
+    }
+    return true;
+}
+
+void SerialIoWorker::requeueFront(int idx)
+{
+    QMutexLocker locker(&m_cmdMutex);
+    const Transaction &t = m_txPool[idx];
+    if (t.priority == TX_PRIORITY_TELEMETRY && t.frame[1] == CMD_READ_DATA) {
+        if (m_pendingReadIds.test(t.frame[2])) {
+            m_cmdCoalesced.fetch_add(1, std::memory_order_relaxed);
+            m_txPool.release(idx);
+            return; // 已有同一数据ID的新读请求排队，不再重发旧请求
+        }
+        m_pendingReadIds.set(t.frame[2]);
+    }
+    m_txPool.pushFront(m_cmdLanes[t.priority], idx);
+    ++m_cmdQueued;
+}
+
+void SerialIoWorker::armTimeoutTimer()
+{
+    if (m_inflight.isEmpty()) {
+        m_timeoutTimer->stop();
+        return;
+    }
+
+    // 在途请求按发送时刻排序，只需等待最早的一个
+    qint64 deadline = m_txPool[m_inflight.head].txNs + qint64(m_requestTimeoutMs.load(std::memory_order_relaxed)) * 1000000;
+    qint64 remainNs = deadline - monotonicNowNs();
+    m_timeoutTimer->start(remainNs > 0 ? int((remainNs + 999999) / 1000000) : 0);
+}
+
+void SerialIoWorker::onRequestTimeout()
+{
+    qint64 now = monotonicNowNs();
+    qint64 timeoutNs = qint64(m_requestTimeoutMs.load(std::memory_order_relaxed)) * 1000000;
+    int maxRetries = m_maxRetries.load(std::memory_order_relaxed);
+
+    while (!m_inflight.isEmpty() && now - m_txPool[m_inflight.head].txNs >= timeoutNs) {
+        int idx = m_txPool.popFront(m_inflight);
+        Transaction &t = m_txPool[idx];
+        if (t.retries < maxRetries) {
+            // 放回所在优先级通道的队首，优先于同级新命令重发
+            ++t.retries;
+            requeueFront(idx);
+            m_txRetries.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_txTimeouts.fetch_add(1, std::memory_order_relaxed);
+            // 链路无应答时每个请求都会超时：只在收到应答后的首次超时打印，其余只计数
+            if (!m_timeoutLogged) {
+                m_timeoutLogged = true;
+                qDebug() << "请求超时已放弃，命令字: 0x" << QString::number(t.frame[1], 16).toUpper()
+                         << "（恢复应答前的后续超时只计入txTimeouts）";
+            }
+            QMutexLocker locker(&m_cmdMutex);
+            m_txPool.release(idx);
+        }
+    }
+    m_txInFlight.store(m_inflight.size, std::memory_order_relaxed);
+
+    armTimeoutTimer();
+    processCmdQueue(); // 窗口已腾出，发送重发请求和新请求（安全类命令的重发立即写出）
+}
+
+bool SerialIoWorker::matchResponse(const uint8_t *frame, qint64 rxNs)
+{
+    int prev = TxPool::NIL;
+    for (int idx = m_inflight.head; idx != TxPool::NIL; prev = idx, idx = m_txPool.next(idx)) {
+        if (responseMatches(m_txPool[idx].frame, frame)) {
+            qint64 rttNs = rxNs - m_txPool[idx].txNs;
+            m_txPool.remove(m_inflight, idx, prev);
+            {
+                QMutexLocker locker(&m_cmdMutex);
+                m_txPool.release(idx);
+            }
+            m_txInFlight.store(m_inflight.size, std::memory_order_relaxed);
+
+            m_timeoutLogged = false;
+            m_txCompleted.fetch_add(1, std::memory_order_relaxed);
+            m_txRttSumNs.fetch_add(rttNs, std::memory_order_relaxed);
+            if (rttNs > m_txRttMaxNs.load(std::memory_order_relaxed)) {
+                m_txRttMaxNs.store(rttNs, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false; // 主动上报或已超时放弃的请求的迟到应答
+}
+
+void SerialIoWorker::onReadyRead()
+{
+    if (!m_rxRingbuf) {
+        m_device->readAll();
+        return;
+    }
+
+    qint64 readNs = monotonicNowNs();
+    bool rawTap = m_rawTapEnabled.load(std::memory_order_relaxed);
+    QByteArray rawData; // 仅在开启显示旁路时填充
+    int frames = 0;
+
+    // 串口数据直接读入环形缓冲区的可写区域，缓冲区满时先解析腾出空间
+    while (m_device->bytesAvailable() > 0) {
+        ringbuf_span_t spans[2];
+        if (ringbuf_get_write_spans(m_rxRingbuf, spans) == 0) {
+            frames += parseProtocol(readNs);
+            if (ringbuf_get_write_spans(m_rxRingbuf, spans) == 0) {
+                ringbuf_remove(m_rxRingbuf, ringbuf_len(m_rxRingbuf)); // 缓冲区全是无法解析的数据，丢弃后重新同步
+                continue;
+            }
+        }
+
+        qint64 got = 0;
+        for (int i = 0; i < 2 && spans[i].len > 0; ++i) {
+            qint64 n = m_device->read(reinterpret_cast<char*>(spans[i].data), spans[i].len);
+            if (n <= 0) {
+                break;
+            }
+            if (rawTap) {
+                rawData.append(reinterpret_cast<const char*>(spans[i].data), n);
+            }
+            if (m_recorder) {
+                m_recorder->append(false, readNs, reinterpret_cast<const char*>(spans[i].data), int(n));
+            }
+            got += n;
+            if (n < spans[i].len) {
+                break;
+            }
+        }
+        if (got == 0) {
+            break;
+        }
+        ringbuf_commit(m_rxRingbuf, uint32_t(got));
+        m_totalBytesRead.fetch_add(got, std::memory_order_relaxed);
+    }
+
+    // 解析出缓冲区中所有完整帧
+    frames += parseProtocol(readNs);
+    m_prevReadNs = readNs;
+
+    m_rxWakeups.fetch_add(1, std::memory_order_relaxed);
+    m_rxWakeupFrames.fetch_add(frames, std::memory_order_relaxed);
+    if (frames > m_maxFramesPerWakeup.load(std::memory_order_relaxed)) {
+        m_maxFramesPerWakeup.store(frames, std::memory_order_relaxed);
+    }
+
+    if (!rawData.isEmpty()) {
+        emit dataRead(rawData, readNs);
+    }
+}
+
+void SerialIoWorker::onErrorOccurred(QSerialPort::SerialPortError error)
+{
+    if (error != QSerialPort::NoError) {
+        emit portErrorOccurred(m_serialPort->errorString());
+    }
+}
+
+int SerialIoWorker::parseProtocol(qint64 readNs)
+{
+    // 协议解析方法：循环解出缓冲区中所有完整的数据包，直到剩余数据不足一帧
+    // 创建一个临时ringbuf指针，指向接收缓冲区
+    ringbuf_t *cmd_rb = m_rxRingbuf;
+
+    const uint8_t cmd_len = PROTOCOL_LENGTH; // 使用固定包长
+    const uint32_t sum_len = cmd_len - 2;     // 校验范围：包头到数据区结束
+    int frameCount = 0;
+    int matched = 0;
+
+    // 重同步时的滑动校验和：sumValid时sum为当前位置[0..sum_len-1]的累加和
+    bool sumValid = false;
+    uint16_t sum = 0;
+
+    // 丢弃d字节重新同步：逐字节前移时滑动校验和，跳跃较远时不如重新累加，直接作废
+    auto skip = [&](uint32_t d) {
+        if (sumValid && d == 1 && ringbuf_len(cmd_rb) > sum_len) {
+            sum = ringbuf_checksum_slide(cmd_rb, sum, 0, sum_len);
+        } else {
+            sumValid = false;
+        }
+        ringbuf_remove(cmd_rb, d);
+    };
+
+    // 协商v2后同时识别v2包头；v2帧最短只有帧头+CRC
+    bool v2 = m_protocolVersion.load(std::memory_order_relaxed) >= 2;
+    uint32_t min_len = v2 ? PROTOCOL_V2_HEADER_LENGTH + PROTOCOL_V2_CRC_LENGTH : cmd_len;
+
+    while (ringbuf_len(cmd_rb) >= min_len) {
+        // 查找协议包头：按连续内存段快速扫描，一次丢弃包头之前的全部无效数据
+        uint8_t head = ringbuf_get_at(cmd_rb, 0);
+        if (head != PROTOCOL_HEADER && !(v2 && head == PROTOCOL_V2_HEADER)) {
+            int32_t header_pos = v2 ? ringbuf_find2(cmd_rb, 1, PROTOCOL_HEADER, PROTOCOL_V2_HEADER)
+                                    : ringbuf_find(cmd_rb, 1, PROTOCOL_HEADER);
+            if (header_pos < 0) {
+                ringbuf_remove(cmd_rb, ringbuf_len(cmd_rb)); // 没有包头，全部丢弃
+                break;
+            }
+            skip((uint32_t)header_pos);
+            continue;
+        }
+
+        if (head == PROTOCOL_V2_HEADER) {
+            int result = parseFrameV2(readNs, matched);
+            if (result < 0) {
+                skip(1); // 帧头或CRC校验失败，丢弃一个字节
+                continue;
+            }
+            if (result == 0) {
+                break; // 帧头有效但数据未收全，等待后续数据
+            }
+            sumValid = false;
+            ++frameCount;
+            continue;
+        }
+
+        if (ringbuf_len(cmd_rb) < cmd_len) {
+            break; // v1帧未收全
+        }
+
+        // 先检查包尾（代价最小），不匹配时丢弃该候选包头
+        if (ringbuf_get_at(cmd_rb, cmd_len - 1) != PROTOCOL_FOOTER) {
+            skip(1); // 包尾不匹配，丢弃一个字节
+            continue;
+        }
+
+        // 计算校验和（从包头到数据区结束，不包括包尾和校验字节）
+        // ringbuf_checksum返回16位累加和，取低8位作为校验和
+        if (!sumValid) {
+            sum = ringbuf_checksum(cmd_rb, 0, sum_len - 1);
+            sumValid = true;
+        }
+        uint8_t calc_checksum = (uint8_t)(sum & 0xFF);
+        uint8_t recv_checksum = ringbuf_get_at(cmd_rb, cmd_len - 2);
+
+        if (calc_checksum != recv_checksum) {
+            skip(1); // 校验失败，丢弃一个字节
+            continue;
+        }
+        sumValid = false; // 整帧取出后窗口不再重叠
+
+        // 从缓冲区可读区域直接取出完整数据包（跨越缓冲区末尾时分两段）
+        RxFrame frame;
+        ringbuf_span_t spans[2];
+        ringbuf_get_read_spans(cmd_rb, spans);
+        uint32_t first_len = spans[0].len < PROTOCOL_LENGTH ? spans[0].len : PROTOCOL_LENGTH;
+        memcpy(frame.data, spans[0].data, first_len);
+        memcpy(frame.data + first_len, spans[1].data, PROTOCOL_LENGTH - first_len);
+
+        // 移除已处理的数据包
+        ringbuf_consume(cmd_rb, PROTOCOL_LENGTH);
+
+        // 放入帧队列，由GUI线程批量取出
+        frame.readNs = readNs;
+        frame.decodeNs = monotonicNowNs();
+        frame.rxNs = frameArrivalNs(readNs);
+
+        // 应答释放在途请求的窗口
+        if (matchResponse(frame.data, frame.rxNs)) {
+            ++matched;
+        }
+
+        // 协商应答：立即切换协议版本，缓冲区中随后的v2帧按新版本解析
+        if (frame.data[1] == CMD_PROTOCOL_NEGOTIATE && frame.data[2] == RESPONSE_OK) {
+            v2 = frame.data[3] >= 2;
+            min_len = v2 ? PROTOCOL_V2_HEADER_LENGTH + PROTOCOL_V2_CRC_LENGTH : cmd_len;
+            m_protocolVersion.store(v2 ? 2 : 1, std::memory_order_relaxed);
+            m_rxV2SeqValid = false;
+        }
+
+        if (!m_rxFrames.push(frame)) {
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        ++frameCount;
+    }
+
+    // 有请求完成时补发后续请求，并按剩余最早请求重新设定超时
+    if (matched > 0) {
+        armTimeoutTimer();
+        processCmdQueue();
+    }
+
+    // 本次解出的所有帧只通知一次
+    if (frameCount > 0 && !m_framesNotifyPending.exchange(true, std::memory_order_acq_rel)) {
+        emit framesReady();
+    }
+    return frameCount;
+}
+
+qint64 SerialIoWorker::frameArrivalNs(qint64 readNs)
+{
+    if (m_device == m_replayDevice) {
+        // 回放：帧尾所在记录的送出时刻，保留录制时的帧间隔而不是回放读出的时刻
+        qint64 frameEnd = m_replayDevice->bytesRead() - qint64(ringbuf_len(m_rxRingbuf));
+        qint64 ns = qMax(m_replayDevice->timeAtOffset(frameEnd), m_lastRxArrivalNs);
+        m_lastRxArrivalNs = ns;
+        return ns;
+    }
+
+    // 帧刚从缓冲区取出：其后还有tail字节在读出时刻之前已经到达，帧尾至少早到tail个字节时间
+    qint64 tail = qint64(ringbuf_len(m_rxRingbuf)) + m_device->bytesAvailable();
+    qint64 ns = readNs - tail * m_byteWireNs;
+    ns = qMax(ns, m_prevReadNs);
+    ns = qMax(ns, m_lastRxArrivalNs);
+    m_lastRxArrivalNs = ns;
+    return ns;
+}
+
+int SerialIoWorker::parseFrameV2(qint64 readNs, int &matched)
+{
+    ringbuf_t *rb = m_rxRingbuf;
+
+    // 帧头：包头、命令字、序号、载荷长度、帧头校验；先校验帧头，避免噪声中的0xA5按错误长度等待
+    uint8_t header[PROTOCOL_V2_HEADER_LENGTH];
+    ringbuf_peek(rb, 0, PROTOCOL_V2_HEADER_LENGTH, header);
+    uint32_t payloadLen = uint32_t(header[3]) | (uint32_t(header[4]) << 8);
+    if (header[5] != ProtocolEncoder::v2HeaderCheck(header) || payloadLen > PROTOCOL_V2_MAX_PAYLOAD) {
+        return -1;
+    }
+
+    uint32_t crcLen = PROTOCOL_V2_HEADER_LENGTH + payloadLen;
+    uint32_t frameLen = crcLen + PROTOCOL_V2_CRC_LENGTH;
+    if (ringbuf_len(rb) < frameLen) {
+        return 0;
+    }
+
+    uint16_t recvCrc = uint16_t(ringbuf_get_at(rb, crcLen) | (ringbuf_get_at(rb, crcLen + 1) << 8));
+    if (ringbuf_crc16(rb, 0, crcLen) != recvCrc) {
+        m_rxV2CrcErrors.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    // 序号不连续说明中间有帧丢失（串口溢出或校验失败）
+    uint8_t seq = header[2];
+    if (m_rxV2SeqValid && seq != m_rxV2NextSeq) {
+        m_rxV2SeqGaps.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_rxV2NextSeq = uint8_t(seq + 1);
+    m_rxV2SeqValid = true;
+
+    // 载荷直接从环形缓冲区复制到队列元素
+    RxBlock block;
+    block.cmd = header[1];
+    block.seq = seq;
+    block.length = uint16_t(payloadLen);
+    ringbuf_peek(rb, PROTOCOL_V2_HEADER_LENGTH, payloadLen, block.payload);
+    ringbuf_consume(rb, frameLen);
+    block.readNs = readNs;
+    block.decodeNs = monotonicNowNs();
+    block.rxNs = frameArrivalNs(readNs);
+
+    // 突发捕获分块读取的数据块以v2帧到达：载荷首字节为子命令，按v1应答的位置组成匹配键
+    if (block.cmd == CMD_BURST_CAPTURE && block.length > 0) {
+        const uint8_t key[3] = { PROTOCOL_V2_HEADER, block.cmd, block.payload[0] };
+        if (matchResponse(key, block.rxNs)) {
+            ++matched;
+        }
+    }
+
+    m_rxV2Blocks.fetch_add(1, std::memory_order_relaxed);
+    if (!m_rxBlocks.push(block)) {
+        m_droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    return 1;
+}
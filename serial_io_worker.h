@@ -0,0 +1,347 @@
+#ifndef SERIAL_IO_WORKER_H
+#define SERIAL_IO_WORKER_H
+
+#include <QObject>
+#include <QEvent>
+#include <QSerialPort>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QtMath>
+#include <QTimer>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+
+#include "ringbuf.h"
+#include "spsc_queue.h"
+#include "frame_pool.h"
+#include "protocol_frame.h"
+
+class SimulatedDevice;
+class SessionRecorder;
+class ReplayDevice;
+
+// 单调时钟（纳秒），用于各级收发延迟统计
+inline qint64 monotonicNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 延迟统计（统计窗口内的平均值与最大值）
+struct LatencyStat {
+    qint64 sumNs = 0;
+    qint64 maxNs = 0;
+    qint64 count = 0;
+
+    void add(qint64 ns) {
+        sumNs += ns;
+        if (ns > maxNs) maxNs = ns;
+        ++count;
+    }
+    double avgUs() const { return count > 0 ? sumNs / 1000.0 / count : 0.0; }
+    double maxUs() const { return maxNs / 1000.0; }
+    void reset() { sumNs = maxNs = count = 0; }
+};
+
+// 已解析的协议帧（I/O线程 -> GUI线程）
+struct RxFrame {
+    uint8_t data[PROTOCOL_LENGTH]; // 完整的14字节协议包
+    qint64 readNs;                 // 从串口读出的时刻
+    qint64 decodeNs;               // 完成解包校验的时刻
+    qint64 rxNs;                   // 帧尾到达时刻（由读出时刻按其后字节数和波特率倒推，单调时钟）
+};
+
+// I/O线程解析出的v2变长帧（协商v2后的批量数据），经无锁队列交给GUI线程
+struct RxBlock {
+    uint8_t cmd;                              // 命令字
+    uint8_t seq;                              // 帧序号
+    uint16_t length;                          // 载荷长度
+    uint8_t payload[PROTOCOL_V2_MAX_PAYLOAD]; // 载荷
+    qint64 readNs;                            // 从串口读出的时刻
+    qint64 decodeNs;                          // 完成解包校验的时刻
+    qint64 rxNs;                              // 帧尾到达时刻（同RxFrame::rxNs）
+};
+
+// 命令发送优先级（数值越小越优先）
+enum TxPriority {
+    TX_PRIORITY_SAFETY = 0,     // 安全类（停机）：抢占一切，不受在途窗口、链路节拍和队列上限限制
+    TX_PRIORITY_CONTROL,        // 控制设定值
+    TX_PRIORITY_PARAM,          // 参数写入与配置
+    TX_PRIORITY_TELEMETRY,      // 周期读取
+    TX_PRIORITY_COUNT
+};
+
+// 按命令字确定默认优先级
+TxPriority defaultTxPriority(uint8_t cmd);
+
+/**
+ * @brief 串口I/O工作对象 - 运行在独立线程中，独占QSerialPort
+ *
+ * 串口的打开/关闭、读、写、flush与错误处理全部在I/O线程完成，
+ * 解析出的协议帧经无锁队列交给GUI线程，GUI繁忙时不会阻塞收发。
+ * 端口名为SimulatedDevice::PORT_NAME时改用模拟电机，收发路径不变。
+ */
+class SerialIoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const uint32_t DEFAULT_RX_RING_SIZE = 64 * 1024; // 接收环形缓冲区默认容量（2的幂）
+    static const int DEFAULT_TX_WINDOW = 4;              // 默认最多在途请求数
+    static const int DEFAULT_REQUEST_TIMEOUT_MS = 100;   // 默认应答超时
+    static const int DEFAULT_MAX_RETRIES = 2;            // 默认超时重发次数
+    static const int DEFAULT_CMD_QUEUE_LIMIT = 256;      // 默认命令队列最大长度
+    static const int DEFAULT_TX_BYTE_BUDGET = 512;       // 默认单次写入最多合并的字节数
+
+    // 发送路径全部使用预分配存储，以下为其上限
+    static const int TX_POOL_SIZE = 1024;                // 命令槽位数（排队+在途）
+    static const int MAX_CMD_QUEUE_LIMIT = 768;          // 命令队列上限的最大值，其余槽位留给在途请求和安全类命令
+    static const int MAX_TX_WINDOW = 128;                // 在途窗口的最大值
+    static const int MAX_TX_BYTE_BUDGET = 4096;          // 单次写入字节预算的最大值
+    static const int MAX_TX_BATCH_FRAMES = MAX_TX_BYTE_BUDGET / PROTOCOL_LENGTH;
+
+    explicit SerialIoWorker(uint32_t rxRingSize = DEFAULT_RX_RING_SIZE, QObject *parent = nullptr);
+    ~SerialIoWorker();
+
+    // 线程安全：将完整命令帧按优先级加入发送队列，返回当前队列长度，队列已满无法入队时返回-1
+    // - priority小于0时按命令字取默认优先级
+    // - 同一数据ID尚未发出的读请求合并为一条（保留原位置，内容以最新为准）
+    // - 队列满时丢弃最早的周期读取（会再次发出）；没有可丢弃的周期读取时拒绝新命令，安全类命令不受限
+    // - 安全类命令以高优先级事件唤醒I/O线程，越过已排队的普通事件立即写出
+    // - 命令存放在预分配的槽位中，稳态下入队、发送、应答匹配都不分配内存
+    int enqueueCmd(const ProtocolFrame &frame, int priority = -1);
+
+    // 一次入队一组命令（如周期读取的整组读请求），只加一次锁、只唤醒一次I/O线程
+    // priority为-1时逐帧按命令字确定；任一帧被拒绝时返回-1，其余帧照常入队
+    int enqueueCmds(const ProtocolFrame *frames, int count, int priority = -1);
+
+    // 命令队列长度上限（线程安全）
+    void setCmdQueueLimit(int limit) { m_cmdQueueLimit.store(qBound(1, limit, MAX_CMD_QUEUE_LIMIT), std::memory_order_relaxed); }
+    int cmdQueueLimit() const { return m_cmdQueueLimit.load(std::memory_order_relaxed); }
+
+    // 命令队列当前长度与最早一条的排队时长
+    void cmdQueueStats(int &depth, qint64 &oldestAgeNs);
+
+    // 累计合并的重复读请求数、因队列满丢弃/拒绝的命令数
+    qint64 cmdCoalesced() const { return m_cmdCoalesced.load(std::memory_order_relaxed); }
+    qint64 cmdDropped() const { return m_cmdDropped.load(std::memory_order_relaxed); }
+
+    // 事务引擎参数（线程安全，下一次发送/超时检查时生效）
+    void setTxWindow(int window) { m_txWindow.store(qBound(1, window, MAX_TX_WINDOW), std::memory_order_relaxed); }
+    int txWindow() const { return m_txWindow.load(std::memory_order_relaxed); }
+    void setRequestTimeoutMs(int ms) { m_requestTimeoutMs.store(qMax(1, ms), std::memory_order_relaxed); }
+    int requestTimeoutMs() const { return m_requestTimeoutMs.load(std::memory_order_relaxed); }
+    void setMaxRetries(int retries) { m_maxRetries.store(qMax(0, retries), std::memory_order_relaxed); }
+    int maxRetries() const { return m_maxRetries.load(std::memory_order_relaxed); }
+
+    // 事务统计：累计超时放弃数、重发数，当前在途请求数
+    qint64 txTimeouts() const { return m_txTimeouts.load(std::memory_order_relaxed); }
+    qint64 txRetries() const { return m_txRetries.load(std::memory_order_relaxed); }
+    int txInFlight() const { return m_txInFlight.load(std::memory_order_relaxed); }
+
+    // 单次写入最多合并的字节数（线程安全，限制在一帧到MAX_TX_BYTE_BUDGET之间）
+    void setTxByteBudget(int bytes) { m_txByteBudget.store(qBound(int(PROTOCOL_LENGTH), bytes, MAX_TX_BYTE_BUDGET), std::memory_order_relaxed); }
+    int txByteBudget() const { return m_txByteBudget.load(std::memory_order_relaxed); }
+
+    // 写串口统计：写调用次数、其中的命令帧数与字节数（取出后清零）
+    void takeWriteStats(qint64 &writes, qint64 &frames, qint64 &bytes) {
+        writes = m_txWrites.exchange(0, std::memory_order_relaxed);
+        frames = m_txWriteFrames.exchange(0, std::memory_order_relaxed);
+        bytes = m_txWriteBytes.exchange(0, std::memory_order_relaxed);
+    }
+
+    // 安全类命令入队->写入串口的延迟：最近一次与历史最大值
+    qint64 safetyLatencyNs() const { return m_safetyLatencyNs.load(std::memory_order_relaxed); }
+    qint64 safetyLatencyMaxNs() const { return m_safetyLatencyMaxNs.load(std::memory_order_relaxed); }
+
+    // 已完成事务数与请求->应答往返时间（取出后清零）
+    void takeTxStats(qint64 &completed, qint64 &rttSumNs, qint64 &rttMaxNs) {
+        completed = m_txCompleted.exchange(0, std::memory_order_relaxed);
+        rttSumNs = m_txRttSumNs.exchange(0, std::memory_order_relaxed);
+        rttMaxNs = m_txRttMaxNs.exchange(0, std::memory_order_relaxed);
+    }
+
+    // GUI线程调用：取出已解析的协议帧
+    bool popFrame(RxFrame &frame) { return m_rxFrames.pop(frame); }
+
+    // GUI线程在取帧前调用，允许I/O线程发出下一次通知
+    void clearFramesNotify() { m_framesNotifyPending.store(false, std::memory_order_release); }
+
+    // 因帧队列满而丢弃的帧数
+    qint64 droppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+    // GUI线程调用：取出已解析的v2变长帧（与popFrame共用framesReady通知）
+    bool popBlock(RxBlock &block) { return m_rxBlocks.pop(block); }
+
+    // 当前生效的协议版本：1为仅v1帧；2为电机可发送v2变长帧（由协商应答切换，串口关闭时恢复1）
+    int protocolVersion() const { return m_protocolVersion.load(std::memory_order_relaxed); }
+
+    // v2帧统计：已解出帧数、序号不连续（丢帧）次数、CRC错误数、因队列满丢弃数
+    qint64 rxV2Blocks() const { return m_rxV2Blocks.load(std::memory_order_relaxed); }
+    qint64 rxV2SeqGaps() const { return m_rxV2SeqGaps.load(std::memory_order_relaxed); }
+    qint64 rxV2CrcErrors() const { return m_rxV2CrcErrors.load(std::memory_order_relaxed); }
+    qint64 droppedBlocks() const { return m_droppedBlocks.load(std::memory_order_relaxed); }
+
+    // 接收原始数据旁路：开启时才为显示复制一份原始数据（dataRead信号）
+    void setRawTapEnabled(bool enabled) { m_rawTapEnabled.store(enabled, std::memory_order_relaxed); }
+
+    // 发送数据旁路：开启时才为显示复制一份已写出的命令（dataWritten信号）
+    void setTxTapEnabled(bool enabled) { m_txTapEnabled.store(enabled, std::memory_order_relaxed); }
+
+    // 会话录制：每次读出/写入后把原始数据交给recorder（线程启动前设置一次，recorder须比本对象存活更久）
+    void setRecorder(SessionRecorder *recorder) { m_recorder = recorder; }
+
+    // 会话回放状态（任意线程可读）：录制时长、当前位置（相对录制开始）、累计送出字节数、是否已放完
+    qint64 replayDurationNs() const;
+    qint64 replayPositionNs() const;
+    qint64 replayBytes() const;
+    bool replayFinished() const;
+
+    // 累计发送字节数
+    qint64 totalBytesWritten() const { return m_totalBytesWritten.load(std::memory_order_relaxed); }
+
+    // 累计接收字节数
+    qint64 totalBytesRead() const { return m_totalBytesRead.load(std::memory_order_relaxed); }
+
+    // 接收环形缓冲区容量、高水位与溢出丢弃字节数（任意线程可读）
+    uint32_t rxRingCapacity() const { return m_rxRingbuf ? m_rxRingbuf->size : 0; }
+    uint32_t rxRingHighWater() const { return m_rxRingbuf ? ringbuf_high_water(m_rxRingbuf) : 0; }
+    uint32_t rxRingDropped() const { return m_rxRingbuf ? ringbuf_dropped(m_rxRingbuf) : 0; }
+
+    // 每次唤醒解出的帧数统计（取出后清零）
+    void takeWakeupStats(qint64 &wakeups, qint64 &frames, int &maxFrames) {
+        wakeups = m_rxWakeups.exchange(0, std::memory_order_relaxed);
+        frames = m_rxWakeupFrames.exchange(0, std::memory_order_relaxed);
+        maxFrames = m_maxFramesPerWakeup.exchange(0, std::memory_order_relaxed);
+    }
+
+public slots:
+    QString openPort(const QString &portName, int baudRate); // 成功返回空字符串，失败返回错误信息
+    void closePort();
+    void writeRaw(const QByteArray &data);
+    void setReplaySpeed(double speed);  // 1为实时，N为N倍速，小于等于0为尽快回放
+    void seekReplay(qint64 offsetNs);   // 定位到相对录制开始offsetNs处
+
+signals:
+    void framesReady();                          // 有新的协议帧可取（多帧合并为一次通知）
+    // 以下两个信号仅在开启旁路时发射，用于显示；timestampNs为读出/写入时刻（单调时钟纳秒）
+    void dataRead(const QByteArray &data, qint64 timestampNs);    // 原始接收数据
+    void dataWritten(const QByteArray &data, qint64 timestampNs); // 已写入串口的数据
+    void portErrorOccurred(const QString &error);
+    void errorOccurred(const QString &error);
+
+private slots:
+    void onReadyRead();
+    void onErrorOccurred(QSerialPort::SerialPortError error);
+    void processCmdQueue(); // 处理命令队列：在窗口和链路带宽允许时发出请求
+    void onRequestTimeout(); // 检查在途请求超时，重发或放弃
+
+protected:
+    bool event(QEvent *e) override;
+
+private:
+    // 一条命令从入队、发送到收到应答的全过程
+    struct Transaction {
+        ProtocolFrame frame; // 完整请求帧
+        qint64 enqueueNs;  // 入队时刻（重发不更新，用于统计排队时长）
+        qint64 txNs;       // 最近一次发送时刻
+        int priority;      // TxPriority
+        int retries;       // 已重发次数
+    };
+
+    int parseProtocol(qint64 readNs); // 协议解包函数，返回本次解出的帧数
+    int parseFrameV2(qint64 readNs, int &matched); // 缓冲区首字节为v2包头：解出返回1，数据不足返回0，不是有效帧返回-1；应答了在途请求时matched加1
+    bool matchResponse(const uint8_t *frame, qint64 rxNs); // 应答与在途请求匹配，匹配成功返回true
+    qint64 frameArrivalNs(qint64 readNs); // 刚取出的帧的帧尾到达时刻
+    void sendSafetyCmds(); // 立即写出全部安全类命令
+    bool writeBatch();     // 将m_txBatch中的命令合并为一次写入，成功后转为在途请求（回放时直接完成）
+    bool enqueueLocked(const ProtocolFrame &frame, int priority, qint64 now); // 调用方持有m_cmdMutex，被拒绝返回false
+    void requeueFront(int idx);
+    void armTimeoutTimer();
+
+    QSerialPort *m_serialPort;
+    SimulatedDevice *m_simDevice;
+    ReplayDevice *m_replayDevice;
+    QIODevice *m_device;     // 当前使用的设备：串口、模拟电机或会话回放
+    QTimer *m_cmdTimer;      // 链路节拍定时器：链路忙时等待到可发送时刻
+    QTimer *m_timeoutTimer;  // 最早在途请求的超时定时器
+    qint64 m_frameWireNs;    // 一帧在链路上的传输时间（按波特率推算）
+    qint64 m_byteWireNs;     // 一个字节在链路上的传输时间
+    qint64 m_linkBusyUntilNs; // 已写入数据预计发送完毕的时刻
+
+    // 命令槽位池：各优先级通道与在途列表都是池内槽位的链表
+    // 空闲槽位与通道由m_cmdMutex保护，在途列表只在I/O线程访问
+    using TxPool = FramePool<Transaction, TX_POOL_SIZE>;
+    TxPool m_txPool;
+
+    // 命令队列 - 每条命令14字节，每个优先级一条通道
+    TxPool::List m_cmdLanes[TX_PRIORITY_COUNT];
+    int m_cmdQueued;                   // 各通道命令总数
+    std::bitset<256> m_pendingReadIds; // 周期读取通道中已有读请求的数据ID
+    QMutex m_cmdMutex;
+    std::atomic<int> m_cmdQueueLimit;
+    std::atomic<qint64> m_cmdCoalesced;
+    std::atomic<qint64> m_cmdDropped;
+    std::atomic<bool> m_cmdScheduled; // 已投递处理请求，避免重复唤醒
+
+    // 事务引擎
+    TxPool::List m_inflight;        // 已发出、等待应答的请求（按发送时刻排序）
+    std::atomic<int> m_txWindow;
+    std::atomic<int> m_requestTimeoutMs;
+    std::atomic<int> m_maxRetries;
+    std::atomic<int> m_txInFlight;
+    std::atomic<qint64> m_txTimeouts;
+    bool m_timeoutLogged;           // 上次收到应答后已打印过超时日志
+    std::atomic<qint64> m_txRetries;
+    std::atomic<qint64> m_txCompleted;
+    std::atomic<qint64> m_txRttSumNs;
+    std::atomic<qint64> m_txRttMaxNs;
+    std::atomic<qint64> m_safetyLatencyNs;
+    std::atomic<qint64> m_safetyLatencyMaxNs;
+
+    // 写合并：待写命令槽位与合并后的发送缓冲（定长，不分配）
+    std::array<int, MAX_TX_BATCH_FRAMES> m_txBatch;
+    int m_txBatchSize;
+    std::array<char, MAX_TX_BYTE_BUDGET> m_txBuffer;
+    std::atomic<int> m_txByteBudget;
+    std::atomic<bool> m_txTapEnabled;
+    std::atomic<qint64> m_totalBytesWritten;
+    std::atomic<qint64> m_txWrites;
+    std::atomic<qint64> m_txWriteFrames;
+    std::atomic<qint64> m_txWriteBytes;
+
+    // 协议接收缓冲区：串口数据直接读入，协议帧在缓冲区内原地解析
+    ringbuf_t *m_rxRingbuf;
+    std::atomic<bool> m_rawTapEnabled;
+    std::atomic<qint64> m_totalBytesRead;
+    SessionRecorder *m_recorder;
+
+    // 已解析帧队列
+    SpscQueue<RxFrame, 1024> m_rxFrames;
+    std::atomic<bool> m_framesNotifyPending;
+    std::atomic<qint64> m_droppedFrames;
+
+    // 到达时刻推算：一次读出的多帧按其后仍在缓冲区和驱动中的字节数倒推，
+    // 结果不早于上一次读出（此前未到齐）且不早于上一帧
+    qint64 m_prevReadNs;
+    qint64 m_lastRxArrivalNs;
+
+    // v2变长帧：载荷较大，单独排队
+    SpscQueue<RxBlock, 64> m_rxBlocks;
+    std::atomic<int> m_protocolVersion;
+    uint8_t m_rxV2NextSeq;
+    bool m_rxV2SeqValid;
+    std::atomic<qint64> m_rxV2Blocks;
+    std::atomic<qint64> m_rxV2SeqGaps;
+    std::atomic<qint64> m_rxV2CrcErrors;
+    std::atomic<qint64> m_droppedBlocks;
+
+    // 批量解包统计
+    std::atomic<qint64> m_rxWakeups;
+    std::atomic<qint64> m_rxWakeupFrames;
+    std::atomic<int> m_maxFramesPerWakeup;
+};
+
+#endif // SERIAL_IO_WORKER_H
@@ -0,0 +1,214 @@
+#include "session_recorder.h"
+#include "serial_io_worker.h" // monotonicNowNs
+#include "protocol_frame.h"   // crc16
+#include <QDateTime>
+#include <QMutexLocker>
+#include <cstring>
+
+using namespace SessionFormat;
+
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QObject(parent)
+    , m_writerThread(nullptr)
+    , m_active(0)
+    , m_pendingWrite(false)
+    , m_stopRequested(true)
+    , m_recording(false)
+    , m_bytesWritten(0)
+    , m_recordsWritten(0)
+    , m_droppedBytes(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+QString SessionRecorder::start(const QString &path, const QString &portName, int baudRate)
+{
+    stop();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return QString("无法创建录制文件: %1").arg(m_file.errorString());
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.fileHeaderBytes = sizeof(FileHeader);
+    header.chunkHeaderBytes = sizeof(ChunkHeader);
+    header.recordHeaderBytes = RECORD_HEADER_BYTES;
+    header.startWallMs = QDateTime::currentMSecsSinceEpoch();
+    header.startMonoNs = monotonicNowNs();
+    header.baudRate = uint32_t(qMax(0, baudRate));
+    QByteArray name = portName.toUtf8().left(int(sizeof(header.portName)) - 1);
+    memcpy(header.portName, name.constData(), size_t(name.size()));
+    if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header))
+        || !m_file.flush()) {
+        QString error = QString("写入录制文件失败: %1").arg(m_file.errorString());
+        m_file.close();
+        return error;
+    }
+
+    // 两块缓冲一次分配到位，录制期间append()不再分配
+    {
+        QMutexLocker locker(&m_mutex);
+        for (Chunk &chunk : m_chunks) {
+            chunk.data.resize(CHUNK_BYTES);
+            resetChunk(chunk);
+        }
+        m_active = 0;
+        m_pendingWrite = false;
+        m_stopRequested = false;
+    }
+    m_bytesWritten.store(sizeof(header), std::memory_order_relaxed);
+    m_recordsWritten.store(0, std::memory_order_relaxed);
+    m_droppedBytes.store(0, std::memory_order_relaxed);
+    m_path = path;
+
+    m_writerThread = QThread::create([this]() { writerLoop(); });
+    m_writerThread->setObjectName("SessionWriterThread");
+    m_writerThread->start(QThread::LowPriority);
+    m_recording.store(true, std::memory_order_relaxed);
+    return QString();
+}
+
+void SessionRecorder::stop()
+{
+    if (!m_writerThread) {
+        return;
+    }
+
+    m_recording.store(false, std::memory_order_relaxed);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_wake.wakeOne();
+    }
+    m_writerThread->wait();
+    delete m_writerThread;
+    m_writerThread = nullptr;
+    m_file.close();
+
+    // 写文件线程已退出，I/O线程此后的append()在锁内看到m_stopRequested即返回
+    QMutexLocker locker(&m_mutex);
+    for (Chunk &chunk : m_chunks) {
+        chunk.data = QByteArray();
+        resetChunk(chunk);
+    }
+}
+
+void SessionRecorder::resetChunk(Chunk &chunk)
+{
+    chunk.used = int(sizeof(ChunkHeader));
+    chunk.records = 0;
+    chunk.firstNs = 0;
+    chunk.lastNs = 0;
+}
+
+void SessionRecorder::append(bool isTx, qint64 timestampNs, const char *data, int len)
+{
+    if (!m_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const int maxPiece = CHUNK_BYTES - int(sizeof(ChunkHeader)) - RECORD_HEADER_BYTES;
+    QMutexLocker locker(&m_mutex);
+    if (m_stopRequested) {
+        return;
+    }
+    do {
+        int piece = qMin(len, maxPiece);
+        Chunk *chunk = &m_chunks[m_active];
+        if (chunk->used + RECORD_HEADER_BYTES + piece > CHUNK_BYTES) {
+            if (m_pendingWrite) {
+                // 两块都满：写文件线程跟不上，丢弃而不等待
+                m_droppedBytes.fetch_add(len, std::memory_order_relaxed);
+                return;
+            }
+            m_active ^= 1;
+            m_pendingWrite = true;
+            m_wake.wakeOne();
+            chunk = &m_chunks[m_active];
+        }
+
+        char *out = chunk->data.data() + chunk->used;
+        int64_t ns = timestampNs;
+        uint32_t lengthAndDir = uint32_t(piece) | (isTx ? TX_FLAG : 0u);
+        memcpy(out, &ns, sizeof(ns));
+        memcpy(out + sizeof(ns), &lengthAndDir, sizeof(lengthAndDir));
+        memcpy(out + RECORD_HEADER_BYTES, data, size_t(piece));
+        chunk->used += RECORD_HEADER_BYTES + piece;
+        if (chunk->records++ == 0) {
+            chunk->firstNs = timestampNs;
+        }
+        chunk->lastNs = timestampNs;
+
+        data += piece;
+        len -= piece;
+    } while (len > 0);
+}
+
+void SessionRecorder::writerLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        bool timedOut = false;
+        if (!m_pendingWrite && !m_stopRequested) {
+            timedOut = !m_wake.wait(&m_mutex, FLUSH_INTERVAL_MS);
+        }
+
+        // 到达刷新间隔或停止时，未写满的当前块也交换出来写出
+        if (!m_pendingWrite && (timedOut || m_stopRequested) && m_chunks[m_active].records > 0) {
+            m_active ^= 1;
+            m_pendingWrite = true;
+        }
+
+        if (m_pendingWrite) {
+            Chunk &chunk = m_chunks[m_active ^ 1];
+            locker.unlock();
+            bool ok = writeChunk(chunk);
+            locker.relock();
+            resetChunk(chunk);
+            m_pendingWrite = false;
+            if (!ok) {
+                // 写盘失败：停止录制，已写出的块仍然完整可读
+                m_recording.store(false, std::memory_order_relaxed);
+                m_stopRequested = true;
+                locker.unlock();
+                emit errorOccurred(QString("写入录制文件失败: %1").arg(m_file.errorString()));
+                return;
+            }
+            continue;
+        }
+
+        if (m_stopRequested) {
+            return;
+        }
+    }
+}
+
+bool SessionRecorder::writeChunk(Chunk &chunk)
+{
+    ChunkHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CHUNK_MAGIC;
+    header.payloadBytes = uint32_t(chunk.used) - uint32_t(sizeof(ChunkHeader));
+    header.recordCount = uint32_t(chunk.records);
+    header.crc = ProtocolEncoder::crc16(reinterpret_cast<const uint8_t*>(chunk.data.constData()) + sizeof(ChunkHeader),
+                                        int(header.payloadBytes));
+    header.firstNs = chunk.firstNs;
+    header.lastNs = chunk.lastNs;
+    memcpy(chunk.data.data(), &header, sizeof(header));
+
+    // 块头与载荷一次写出并flush，崩溃时文件末尾最多有一块不完整
+    if (m_file.write(chunk.data.constData(), chunk.used) != chunk.used || !m_file.flush()) {
+        return false;
+    }
+    m_bytesWritten.fetch_add(chunk.used, std::memory_order_relaxed);
+    m_recordsWritten.fetch_add(chunk.records, std::memory_order_relaxed);
+    return true;
+}
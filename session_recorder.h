@@ -0,0 +1,152 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 会话录制文件格式（.focrec）
+ *
+ * 只追加写入，按块组织，所有字段为小端（与x86/ARM主机字节序一致，直接按结构体写入）：
+ *
+ *   [FileHeader 64字节]
+ *   [ChunkHeader 32字节][Record][Record]...   块1
+ *   [ChunkHeader 32字节][Record][Record]...   块2
+ *   ...
+ *
+ * Record = [记录头 12字节][数据 length字节]，一条记录是一次串口读出（RX）或一次写入（TX）。
+ * - 文件头记录各级头部的长度，读取方按长度跳过，以后在头部末尾扩展字段不影响旧的读取方
+ * - 每块带魔数、载荷长度、记录数与载荷CRC-16；块写完即flush，进程崩溃最多损失未写出的一块
+ * - 最后一块被截断时：块头完整即可逐条解析，到数据不足为止的记录仍然有效（CRC不再校验）
+ */
+namespace SessionFormat {
+
+constexpr char FILE_MAGIC[8] = { 'F', 'O', 'C', 'R', 'E', 'C', '\r', '\n' };
+constexpr uint32_t CHUNK_MAGIC = 0x4B484346; // "FCHK"
+constexpr uint16_t VERSION = 1;
+constexpr uint32_t TX_FLAG = 0x80000000u;    // 记录头长度字段的最高位：1为发送
+
+struct FileHeader {
+    char magic[8];              // FILE_MAGIC
+    uint16_t version;           // VERSION
+    uint16_t fileHeaderBytes;   // sizeof(FileHeader)
+    uint16_t chunkHeaderBytes;  // sizeof(ChunkHeader)
+    uint16_t recordHeaderBytes; // RECORD_HEADER_BYTES
+    int64_t startWallMs;        // 开始录制的本地时间（毫秒，Unix纪元）
+    int64_t startMonoNs;        // 开始录制的单调时钟，与记录时刻同一时基
+    uint32_t baudRate;          // 录制时的波特率（未连接为0）
+    uint32_t reserved;
+    char portName[24];          // 端口名（UTF-8，不足补0）
+};
+
+struct ChunkHeader {
+    uint32_t magic;             // CHUNK_MAGIC
+    uint32_t payloadBytes;      // 块内全部记录的总字节数
+    uint32_t recordCount;       // 块内记录数
+    uint16_t crc;               // 载荷CRC-16/CCITT-FALSE
+    uint16_t reserved;
+    int64_t firstNs;            // 块内首末记录的时刻（单调时钟纳秒）
+    int64_t lastNs;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader须为64字节");
+static_assert(sizeof(ChunkHeader) == 32, "ChunkHeader须为32字节");
+
+// 记录头12字节紧凑排列：[0..7]时刻（int64，单调时钟纳秒），[8..11]长度与方向（uint32，低31位为长度，最高位为TX_FLAG）
+constexpr int RECORD_HEADER_BYTES = 12;
+
+} // namespace SessionFormat
+
+/**
+ * @brief 会话录制 - 把串口收发的全部原始数据写入SessionFormat文件
+ *
+ * I/O线程在每次读出/写入后调用append()，数据拷入当前块缓冲即返回：
+ * - 两块缓冲在start()时预分配，append()只做memcpy，不分配内存、不做文件I/O
+ * - 当前块写满或到达刷新间隔时与空闲块交换，由独立的写文件线程写出；
+ *   写文件线程落后、两块都满时丢弃新数据并计数，不阻塞I/O线程
+ * - 锁只保护块缓冲交换，写文件线程在锁外写盘
+ */
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CHUNK_BYTES = 256 * 1024;   // 每块缓冲大小（含块头）
+    static constexpr int FLUSH_INTERVAL_MS = 200;    // 未写满的块最多等待多久写出
+
+    explicit SessionRecorder(QObject *parent = nullptr);
+    ~SessionRecorder();
+
+    /**
+     * @brief 开始录制（GUI线程调用）
+     * @param path 文件路径，已存在时覆盖
+     * @param portName 端口名（写入文件头）
+     * @param baudRate 波特率（写入文件头）
+     * @return 成功返回空字符串，失败返回错误信息
+     */
+    QString start(const QString &path, const QString &portName, int baudRate);
+
+    // 停止录制：写出剩余数据并关闭文件（GUI线程调用，等待写文件线程结束）
+    void stop();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+    QString path() const { return m_path; }
+
+    /**
+     * @brief 追加一条收发记录（I/O线程调用，未在录制时立即返回）
+     * @param isTx true为发送
+     * @param timestampNs 读出/写入时刻（单调时钟纳秒）
+     * @param data 原始字节
+     * @param len 字节数（超过一块时拆成多条同一时刻的记录）
+     */
+    void append(bool isTx, qint64 timestampNs, const char *data, int len);
+
+    // 统计（任意线程可读）：已写入文件的字节数、记录数，因写盘跟不上丢弃的字节数
+    qint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+    qint64 recordsWritten() const { return m_recordsWritten.load(std::memory_order_relaxed); }
+    qint64 droppedBytes() const { return m_droppedBytes.load(std::memory_order_relaxed); }
+
+signals:
+    // 写文件失败（写文件线程发出，录制随即停止写盘）
+    void errorOccurred(const QString &error);
+
+private:
+    // 一块缓冲：前32字节留给块头，写出时填写
+    struct Chunk {
+        QByteArray data;
+        int used = 0;           // 已用字节数（含块头）
+        int records = 0;
+        qint64 firstNs = 0;
+        qint64 lastNs = 0;
+    };
+
+    void writerLoop();
+    bool writeChunk(Chunk &chunk); // 写文件线程调用：填写块头并写出
+    static void resetChunk(Chunk &chunk);
+
+    QFile m_file;
+    QString m_path;
+    QThread *m_writerThread;
+
+    // 双缓冲：m_chunks[m_active]接收append()，另一块等待写出或空闲
+    Chunk m_chunks[2];
+    int m_active;
+    bool m_pendingWrite;        // 另一块已满，等待写文件线程写出
+    bool m_stopRequested;
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+
+    std::atomic<bool> m_recording;
+    std::atomic<qint64> m_bytesWritten;
+    std::atomic<qint64> m_recordsWritten;
+    std::atomic<qint64> m_droppedBytes;
+};
+
+#endif // SESSION_RECORDER_H
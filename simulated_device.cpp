@@ -0,0 +1,599 @@
+#include "simulated_device.h"
+#include <QMetaObject>
+#include <cmath>
+#include <cstring>
+
+static const double SIM_ELECTRICAL_HZ = 50.0;   // 运行时的电频率
+static const float SIM_CURRENT_AMPLITUDE = 5.0f; // 相电流幅值（A）
+static const double SIM_PI = 3.14159265358979323846;
+static const qint64 SIM_CURRENT_LOOP_PERIOD_NS = 50000; // 电流环周期（20kHz PWM）
+static const int SIM_BURST_BUFFER_BYTES = 32768;        // 突发捕获片内缓冲区大小
+static const int SIM_BURST_SCAN_LIMIT = 200000;         // 每次推进最多检测的样本数
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+SimulatedDevice::SimulatedDevice(QObject *parent)
+    : QIODevice(parent)
+    , m_readyReadQueued(false)
+    , m_motorState(MOTOR_STATE_IDLE)
+    , m_controlMode(MOTOR_MODE_SPEED)
+    , m_subIds{}
+    , m_subCount(0)
+    , m_streamPeriodNs(0)
+    , m_nextReportNs(0)
+    , m_streamTimer(new QTimer(this))
+    , m_protocolVersion(1)
+    , m_maxPayload(PROTOCOL_V2_MAX_PAYLOAD)
+    , m_blockIntervalNs(0)
+    , m_blockValues{}
+    , m_blockSamples(0)
+    , m_blockStartNs(0)
+    , m_txSeq(0)
+    , m_burstIds{}
+    , m_burstChannels(0)
+    , m_burstPeriodNs(SIM_CURRENT_LOOP_PERIOD_NS)
+    , m_burstDepth(0)
+    , m_burstPreTrigger(0)
+    , m_burstTriggerMode(BURST_TRIGGER_IMMEDIATE)
+    , m_burstTriggerChannel(0)
+    , m_burstTriggerLevel(0.0f)
+    , m_burstState(BURST_STATE_IDLE)
+    , m_burstArmNs(0)
+    , m_burstScanNs(0)
+    , m_burstTriggerNs(0)
+{
+    m_registers.fill(0);
+    m_registers[DATA_ID_SPEED_TARGET] = floatBits(1000.0f);
+    m_registers[DATA_ID_MAX_CURRENT_LIMIT] = floatBits(10.0f);
+    m_registers[DATA_ID_BUS_VOLTAGE] = floatBits(24.0f);
+    m_registers[DATA_ID_POLE_PAIRS] = floatBits(7.0f);
+
+    m_streamTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_streamTimer, &QTimer::timeout, this, &SimulatedDevice::onStreamTick);
+}
+
+bool SimulatedDevice::open(OpenMode mode)
+{
+    m_rxPending.clear();
+    m_txPending.clear();
+    m_subCount = 0;
+    m_motorState = MOTOR_STATE_IDLE;
+    m_protocolVersion = 1; // 重新打开相当于设备复位
+    m_blockSamples = 0;
+    m_txSeq = 0;
+    m_burstChannels = 0;
+    m_burstState = BURST_STATE_IDLE;
+    m_burstBuffer.clear();
+    m_clock.start();
+    return QIODevice::open(mode);
+}
+
+void SimulatedDevice::close()
+{
+    m_streamTimer->stop();
+    m_subCount = 0;
+    QIODevice::close();
+}
+
+qint64 SimulatedDevice::bytesAvailable() const
+{
+    return m_txPending.size() + QIODevice::bytesAvailable();
+}
+
+qint64 SimulatedDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 n = qMin(maxSize, qint64(m_txPending.size()));
+    memcpy(data, m_txPending.constData(), size_t(n));
+    m_txPending.remove(0, int(n));
+    return n;
+}
+
+qint64 SimulatedDevice::writeData(const char *data, qint64 len)
+{
+    m_rxPending.append(data, int(len));
+
+    // 与主机解包相同：找包头，校验包尾和校验和，不通过则前移1字节
+    int pos = 0;
+    const uint8_t *buf = reinterpret_cast<const uint8_t*>(m_rxPending.constData());
+    while (m_rxPending.size() - pos >= PROTOCOL_LENGTH) {
+        const uint8_t *frame = buf + pos;
+        if (frame[0] != PROTOCOL_HEADER || frame[PROTOCOL_LENGTH - 1] != PROTOCOL_FOOTER) {
+            ++pos;
+            continue;
+        }
+        uint16_t sum = 0;
+        for (int i = 0; i < PROTOCOL_LENGTH - 2; ++i) {
+            sum += frame[i];
+        }
+        if (uint8_t(sum) != frame[PROTOCOL_LENGTH - 2]) {
+            ++pos;
+            continue;
+        }
+        handleRequest(frame);
+        pos += PROTOCOL_LENGTH;
+    }
+    m_rxPending.remove(0, pos);
+
+    emit bytesWritten(len);
+    return len;
+}
+
+void SimulatedDevice::handleRequest(const uint8_t *frame)
+{
+    uint8_t cmd = frame[1];
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+
+    switch (cmd) {
+        case CMD_READ_DATA: {
+            uint32_t value = sampleValue(frame[2]);
+            data[0] = frame[2];
+            memcpy(data + 1, &value, 4); // 小端主机
+            break;
+        }
+        case CMD_WRITE_DATA:
+            m_registers[frame[2]] = ProtocolDecoder::readU32(frame + 3);
+            memcpy(data, frame + 2, 5); // 回读写入值
+            break;
+        case CMD_MOTOR_START:
+            m_motorState = MOTOR_STATE_WORKING;
+            data[0] = RESPONSE_OK;
+            data[1] = m_motorState;
+            break;
+        case CMD_MOTOR_STOP:
+            m_motorState = MOTOR_STATE_IDLE;
+            data[0] = RESPONSE_OK;
+            data[1] = m_motorState;
+            break;
+        case CMD_MOTOR_CALIBRATE:
+            // 校准瞬间完成：应答校准状态，随后回到未工作状态
+            data[0] = RESPONSE_OK;
+            data[1] = MOTOR_STATE_CALIBRATING;
+            m_motorState = MOTOR_STATE_IDLE;
+            break;
+        case CMD_MODE_SET:
+            m_controlMode = frame[2];
+            data[0] = RESPONSE_OK;
+            data[1] = m_controlMode;
+            break;
+        case CMD_STATUS_REPORT:
+        case CMD_STATUS_SUBSCRIBE:
+            handleStatusReport(frame);
+            return;
+        case CMD_PROTOCOL_NEGOTIATE:
+            handleNegotiate(frame);
+            return;
+        case CMD_BURST_CAPTURE:
+            handleBurstCapture(frame);
+            return;
+        default:
+            data[0] = RESPONSE_OK; // 其余设置类命令一律应答成功
+            break;
+    }
+    reply(ProtocolEncoder::encode(cmd, data, PROTOCOL_DATA_LENGTH));
+}
+
+void SimulatedDevice::handleStatusReport(const uint8_t *frame)
+{
+    uint8_t op = frame[2];
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+
+    if (frame[1] == CMD_STATUS_REPORT) {
+        // 原有格式：U/V/W相电流（mA）、速度（RPM）、位置（0.1度），均为int16
+        qint64 now = m_clock.nsecsElapsed();
+        int16_t values[5] = {
+            int16_t(phaseCurrent(0, now) * 1000.0f),
+            int16_t(phaseCurrent(1, now) * 1000.0f),
+            int16_t(phaseCurrent(2, now) * 1000.0f),
+            int16_t(bitsFloat(sampleValue(DATA_ID_SPEED_CURRENT))),
+            int16_t(bitsFloat(sampleValue(DATA_ID_MECHANICAL_ANGLE_CURRENT)) * 10.0f)
+        };
+        memcpy(data, values, sizeof(values));
+        reply(ProtocolEncoder::encode(CMD_STATUS_REPORT, data, PROTOCOL_DATA_LENGTH));
+        return;
+    }
+
+    // 订阅集合变化前先发出已攒的样本，块内通道必须一致
+    flushBlock();
+
+    uint8_t status = RESPONSE_OK;
+    if (op == STATUS_REPORT_SUBSCRIBE || op == STATUS_REPORT_SUBSCRIBE_APPEND) {
+        if (op == STATUS_REPORT_SUBSCRIBE) {
+            m_subCount = 0;
+            uint32_t period = uint32_t(frame[3]) | (uint32_t(frame[4]) << 8);
+            m_streamPeriodNs = qint64(qMax(1u, period)) * 100000;
+        }
+        int count = qMin(int(frame[5]), STATUS_REPORT_IDS_PER_REQUEST);
+        for (int i = 0; i < count; ++i) {
+            uint8_t id = frame[6 + i];
+            if (id < DATA_ID_PHASE_CURRENT_U_TARGET || id > DATA_ID_POSITION_LOOP_EXECUTION_TIME) {
+                status = RESPONSE_SUBSCRIBE_FAILED;
+                continue;
+            }
+            bool subscribed = false;
+            for (int j = 0; j < m_subCount; ++j) {
+                subscribed = subscribed || m_subIds[j] == id;
+            }
+            if (subscribed) {
+                continue; // 重发的追加请求不重复订阅
+            }
+            if (m_subCount >= STATUS_REPORT_MAX_IDS) {
+                status = RESPONSE_SUBSCRIBE_FAILED;
+                continue;
+            }
+            m_subIds[m_subCount++] = id;
+        }
+        if (op == STATUS_REPORT_SUBSCRIBE || !m_streamTimer->isActive()) {
+            m_nextReportNs = m_clock.nsecsElapsed() + m_streamPeriodNs;
+            m_streamTimer->start(int(qMax<qint64>(1, m_streamPeriodNs / 1000000)));
+        }
+    } else if (op == STATUS_REPORT_UNSUBSCRIBE) {
+        m_subCount = 0;
+        m_streamTimer->stop();
+    }
+
+    data[0] = op;
+    data[1] = status;
+    data[2] = uint8_t(m_subCount);
+    reply(ProtocolEncoder::encode(CMD_STATUS_SUBSCRIBE, data, PROTOCOL_DATA_LENGTH));
+}
+
+void SimulatedDevice::onStreamTick()
+{
+    if (m_subCount == 0 || m_streamPeriodNs <= 0) {
+        return;
+    }
+
+    // 定时器只有毫秒精度：按已到期的周期数补发，落后过多时跳过积压的周期
+    qint64 now = m_clock.nsecsElapsed();
+    if (now - m_nextReportNs > 100 * m_streamPeriodNs) {
+        m_nextReportNs = now;
+    }
+    while (m_nextReportNs <= now) {
+        if (m_protocolVersion >= 2) {
+            appendBlockSample(m_nextReportNs);
+        } else {
+            reportSample();
+        }
+        m_nextReportNs += m_streamPeriodNs;
+    }
+    if (m_blockSamples > 0 && now - m_blockStartNs >= m_blockIntervalNs) {
+        flushBlock();
+    }
+}
+
+void SimulatedDevice::reportSample()
+{
+    // v1：每帧带两个数据ID及其值
+    for (int i = 0; i < m_subCount; i += 2) {
+        uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+        uint32_t v0 = sampleValue(m_subIds[i]);
+        data[0] = m_subIds[i];
+        memcpy(data + 1, &v0, 4);
+        if (i + 1 < m_subCount) {
+            uint32_t v1 = sampleValue(m_subIds[i + 1]);
+            data[5] = m_subIds[i + 1];
+            memcpy(data + 6, &v1, 4);
+        }
+        reply(ProtocolEncoder::encode(CMD_STATUS_SUBSCRIBE, data, PROTOCOL_DATA_LENGTH));
+    }
+}
+
+void SimulatedDevice::handleNegotiate(const uint8_t *frame)
+{
+    uint8_t version = frame[2];
+    uint16_t hostPayload = uint16_t(frame[3] | (frame[4] << 8));
+    uint16_t maxBlockMs = uint16_t(frame[5] | (frame[6] << 8));
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+
+    // 载荷至少要放得下满订阅时的一个样本
+    const int minPayload = 1 + STATUS_REPORT_MAX_IDS + 4 + STATUS_REPORT_MAX_IDS * 4;
+    bool supported = version == 1 || (version == 2 && hostPayload >= minPayload);
+    if (supported) {
+        flushBlock(); // 切换前按原版本发出已攒的样本
+        m_protocolVersion = version;
+        m_maxPayload = qMin<int>(hostPayload, PROTOCOL_V2_MAX_PAYLOAD);
+        m_blockIntervalNs = qint64(qMax<uint16_t>(1, maxBlockMs)) * 1000000;
+        data[0] = RESPONSE_OK;
+    } else {
+        data[0] = RESPONSE_PROTOCOL_UNSUPPORTED;
+    }
+    data[1] = uint8_t(m_protocolVersion);
+    data[2] = uint8_t(m_maxPayload);
+    data[3] = uint8_t(m_maxPayload >> 8);
+    reply(ProtocolEncoder::encode(CMD_PROTOCOL_NEGOTIATE, data, PROTOCOL_DATA_LENGTH));
+}
+
+void SimulatedDevice::appendBlockSample(qint64 now)
+{
+    int headerLength = 1 + m_subCount + 4;
+    int sampleLength = m_subCount * 4;
+    if (headerLength + (m_blockSamples + 1) * sampleLength > m_maxPayload) {
+        flushBlock();
+    }
+    if (m_blockSamples == 0) {
+        m_blockStartNs = now;
+    }
+    uint8_t *dst = m_blockValues.data() + m_blockSamples * sampleLength;
+    for (int i = 0; i < m_subCount; ++i) {
+        uint32_t value = sampleValue(m_subIds[i]);
+        memcpy(dst + i * 4, &value, 4); // 小端主机
+    }
+    ++m_blockSamples;
+}
+
+void SimulatedDevice::flushBlock()
+{
+    if (m_blockSamples == 0) {
+        return;
+    }
+    uint8_t payload[PROTOCOL_V2_MAX_PAYLOAD];
+    uint16_t period = uint16_t(qMin<qint64>(0xFFFF, m_streamPeriodNs / 100000));
+    int pos = 0;
+    payload[pos++] = uint8_t(m_subCount);
+    memcpy(payload + pos, m_subIds.data(), size_t(m_subCount));
+    pos += m_subCount;
+    payload[pos++] = uint8_t(m_blockSamples);
+    payload[pos++] = uint8_t(m_blockSamples >> 8);
+    payload[pos++] = uint8_t(period);
+    payload[pos++] = uint8_t(period >> 8);
+    int valuesLength = m_blockSamples * m_subCount * 4;
+    memcpy(payload + pos, m_blockValues.data(), size_t(valuesLength));
+    pos += valuesLength;
+    m_blockSamples = 0;
+
+    uint8_t frame[PROTOCOL_V2_HEADER_LENGTH + PROTOCOL_V2_MAX_PAYLOAD + PROTOCOL_V2_CRC_LENGTH];
+    int length = ProtocolEncoder::encodeV2(CMD_STATUS_SUBSCRIBE, m_txSeq++, payload, pos, frame);
+    m_txPending.append(reinterpret_cast<const char*>(frame), length);
+    scheduleReadyRead();
+}
+
+void SimulatedDevice::handleBurstCapture(const uint8_t *frame)
+{
+    uint8_t op = frame[2];
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+    data[0] = op;
+    data[1] = RESPONSE_OK;
+
+    switch (op) {
+        case BURST_CAPTURE_CONFIG: {
+            uint16_t divider = uint16_t(frame[3] | (frame[4] << 8));
+            int count = frame[5];
+            bool valid = divider > 0 && count > 0 && count <= BURST_CAPTURE_MAX_CHANNELS;
+            for (int i = 0; valid && i < count; ++i) {
+                valid = frame[6 + i] >= DATA_ID_PHASE_CURRENT_U_TARGET && frame[6 + i] <= DATA_ID_POSITION_LOOP_EXECUTION_TIME;
+            }
+            m_burstState = BURST_STATE_IDLE;
+            m_burstBuffer.clear();
+            if (!valid) {
+                m_burstChannels = 0;
+                data[1] = RESPONSE_BURST_CAPTURE_FAILED;
+                break;
+            }
+            m_burstChannels = count;
+            memcpy(m_burstIds.data(), frame + 6, size_t(count));
+            m_burstPeriodNs = SIM_CURRENT_LOOP_PERIOD_NS * divider;
+            m_burstDepth = qMin(0xFFFF, SIM_BURST_BUFFER_BYTES / (4 * count));
+            uint32_t period = uint32_t(m_burstPeriodNs);
+            memcpy(data + 2, &period, 4);
+            data[6] = uint8_t(m_burstDepth);
+            data[7] = uint8_t(m_burstDepth >> 8);
+            break;
+        }
+        case BURST_CAPTURE_ARM: {
+            int preTrigger = frame[9] | (frame[10] << 8);
+            if (m_burstChannels == 0 || frame[3] > BURST_TRIGGER_FALLING
+                || frame[4] >= m_burstChannels || preTrigger >= m_burstDepth) {
+                data[1] = RESPONSE_BURST_CAPTURE_FAILED;
+                break;
+            }
+            m_burstTriggerMode = frame[3];
+            m_burstTriggerChannel = frame[4];
+            m_burstTriggerLevel = bitsFloat(ProtocolDecoder::readU32(frame + 5));
+            m_burstPreTrigger = preTrigger;
+            m_burstBuffer.clear();
+            m_burstArmNs = m_clock.nsecsElapsed();
+            // 预触发样本采满之前不检测触发；立即触发时就在此刻触发
+            m_burstScanNs = m_burstArmNs + qint64(preTrigger) * m_burstPeriodNs;
+            m_burstTriggerNs = m_burstScanNs;
+            m_burstState = m_burstTriggerMode == BURST_TRIGGER_IMMEDIATE ? BURST_STATE_TRIGGERED : BURST_STATE_ARMED;
+            break;
+        }
+        case BURST_CAPTURE_STATUS: {
+            updateBurstCapture();
+            qint64 now = m_clock.nsecsElapsed();
+            int samples = 0;
+            int chunks = 0;
+            if (m_burstState == BURST_STATE_ARMED) {
+                samples = int(qMin<qint64>(m_burstPreTrigger, (now - m_burstArmNs) / m_burstPeriodNs));
+            } else if (m_burstState == BURST_STATE_TRIGGERED) {
+                samples = int(qMin<qint64>(m_burstDepth, m_burstPreTrigger + qMax<qint64>(0, (now - m_burstTriggerNs) / m_burstPeriodNs)));
+            } else if (m_burstState == BURST_STATE_DONE) {
+                samples = m_burstDepth;
+                chunks = (m_burstBuffer.size() + burstChunkBytes() - 1) / burstChunkBytes();
+            }
+            data[2] = m_burstState;
+            data[3] = uint8_t(samples);
+            data[4] = uint8_t(samples >> 8);
+            data[5] = uint8_t(m_burstPreTrigger);
+            data[6] = uint8_t(m_burstPreTrigger >> 8);
+            data[7] = uint8_t(chunks);
+            data[8] = uint8_t(chunks >> 8);
+            break;
+        }
+        case BURST_CAPTURE_READ: {
+            // 数据块本身就是应答；尚未采集完成时没有可读的块
+            int first = frame[3] | (frame[4] << 8);
+            int count = frame[5] | (frame[6] << 8);
+            int chunks = (m_burstBuffer.size() + burstChunkBytes() - 1) / burstChunkBytes();
+            for (int i = first; i < first + count && i < chunks; ++i) {
+                sendBurstChunk(i);
+            }
+            return;
+        }
+        case BURST_CAPTURE_ABORT:
+            m_burstState = BURST_STATE_IDLE;
+            m_burstBuffer.clear();
+            break;
+        default:
+            data[1] = RESPONSE_BURST_CAPTURE_FAILED;
+            break;
+    }
+    reply(ProtocolEncoder::encode(CMD_BURST_CAPTURE, data, PROTOCOL_DATA_LENGTH));
+}
+
+void SimulatedDevice::updateBurstCapture()
+{
+    qint64 now = m_clock.nsecsElapsed();
+
+    if (m_burstState == BURST_STATE_ARMED) {
+        // 逐个电流环样本检测触发通道是否穿越触发电平
+        uint8_t id = m_burstIds[m_burstTriggerChannel];
+        float prev = bitsFloat(sampleValueAt(id, m_burstScanNs - m_burstPeriodNs));
+        for (int n = 0; m_burstScanNs <= now && n < SIM_BURST_SCAN_LIMIT; ++n) {
+            float cur = bitsFloat(sampleValueAt(id, m_burstScanNs));
+            bool rising = prev < m_burstTriggerLevel && cur >= m_burstTriggerLevel;
+            bool falling = prev > m_burstTriggerLevel && cur <= m_burstTriggerLevel;
+            if ((m_burstTriggerMode == BURST_TRIGGER_RISING && rising)
+                || (m_burstTriggerMode == BURST_TRIGGER_FALLING && falling)) {
+                m_burstTriggerNs = m_burstScanNs;
+                m_burstState = BURST_STATE_TRIGGERED;
+                break;
+            }
+            prev = cur;
+            m_burstScanNs += m_burstPeriodNs;
+        }
+    }
+
+    if (m_burstState == BURST_STATE_TRIGGERED) {
+        qint64 lastNs = m_burstTriggerNs + qint64(m_burstDepth - 1 - m_burstPreTrigger) * m_burstPeriodNs;
+        if (lastNs > now) {
+            return;
+        }
+        // 采满：按样本时刻一次性生成整个缓冲区
+        m_burstBuffer.resize(m_burstDepth * m_burstChannels * 4);
+        char *dst = m_burstBuffer.data();
+        for (int k = 0; k < m_burstDepth; ++k) {
+            qint64 ns = m_burstTriggerNs + qint64(k - m_burstPreTrigger) * m_burstPeriodNs;
+            for (int c = 0; c < m_burstChannels; ++c) {
+                uint32_t value = sampleValueAt(m_burstIds[c], ns);
+                memcpy(dst, &value, 4); // 小端主机
+                dst += 4;
+            }
+        }
+        m_burstState = BURST_STATE_DONE;
+    }
+}
+
+int SimulatedDevice::burstChunkBytes() const
+{
+    return m_protocolVersion >= 2 ? BURST_CAPTURE_V2_CHUNK_BYTES : BURST_CAPTURE_V1_CHUNK_BYTES;
+}
+
+void SimulatedDevice::sendBurstChunk(int index)
+{
+    int chunkBytes = burstChunkBytes();
+    int offset = index * chunkBytes;
+    int length = qMin(chunkBytes, int(m_burstBuffer.size()) - offset);
+    const char *src = m_burstBuffer.constData() + offset;
+
+    if (m_protocolVersion >= 2) {
+        uint8_t payload[3 + BURST_CAPTURE_V2_CHUNK_BYTES];
+        payload[0] = BURST_CAPTURE_READ;
+        payload[1] = uint8_t(index);
+        payload[2] = uint8_t(index >> 8);
+        memcpy(payload + 3, src, size_t(length));
+        uint8_t frame[PROTOCOL_V2_HEADER_LENGTH + sizeof(payload) + PROTOCOL_V2_CRC_LENGTH];
+        int frameLength = ProtocolEncoder::encodeV2(CMD_BURST_CAPTURE, m_txSeq++, payload, 3 + length, frame);
+        m_txPending.append(reinterpret_cast<const char*>(frame), frameLength);
+        scheduleReadyRead();
+        return;
+    }
+
+    uint8_t data[PROTOCOL_DATA_LENGTH] = {};
+    data[0] = BURST_CAPTURE_READ;
+    data[1] = uint8_t(index);
+    data[2] = uint8_t(index >> 8);
+    data[3] = uint8_t(length);
+    memcpy(data + 4, src, size_t(length));
+    reply(ProtocolEncoder::encode(CMD_BURST_CAPTURE, data, PROTOCOL_DATA_LENGTH));
+}
+
+void SimulatedDevice::reply(const ProtocolFrame &frame)
+{
+    m_txPending.append(reinterpret_cast<const char*>(frame.data()), PROTOCOL_LENGTH);
+    scheduleReadyRead();
+}
+
+void SimulatedDevice::scheduleReadyRead()
+{
+    // 与真实串口一样异步通知，一次事件循环内的应答合并为一次readyRead
+    if (m_readyReadQueued) {
+        return;
+    }
+    m_readyReadQueued = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_readyReadQueued = false;
+        if (isOpen() && !m_txPending.isEmpty()) {
+            emit readyRead();
+        }
+    }, Qt::QueuedConnection);
+}
+
+float SimulatedDevice::phaseCurrent(int phase, qint64 ns) const
+{
+    if (m_motorState != MOTOR_STATE_WORKING) {
+        return 0.0f;
+    }
+    double t = ns / 1e9;
+    return SIM_CURRENT_AMPLITUDE * float(std::sin(2.0 * SIM_PI * SIM_ELECTRICAL_HZ * t - phase * 2.0 * SIM_PI / 3.0));
+}
+
+uint32_t SimulatedDevice::sampleValue(uint8_t dataId) const
+{
+    return sampleValueAt(dataId, m_clock.nsecsElapsed());
+}
+
+uint32_t SimulatedDevice::sampleValueAt(uint8_t dataId, qint64 ns) const
+{
+    double t = ns / 1e9;
+    bool running = m_motorState == MOTOR_STATE_WORKING;
+    double electrical = running ? std::fmod(360.0 * SIM_ELECTRICAL_HZ * t, 360.0) : 0.0;
+
+    switch (dataId) {
+        case DATA_ID_PHASE_CURRENT_U_TARGET:
+        case DATA_ID_PHASE_CURRENT_U_CURRENT:
+            return floatBits(phaseCurrent(0, ns));
+        case DATA_ID_PHASE_CURRENT_V_TARGET:
+        case DATA_ID_PHASE_CURRENT_V_CURRENT:
+            return floatBits(phaseCurrent(1, ns));
+        case DATA_ID_PHASE_CURRENT_W_TARGET:
+        case DATA_ID_PHASE_CURRENT_W_CURRENT:
+            return floatBits(phaseCurrent(2, ns));
+        case DATA_ID_SPEED_CURRENT:
+            return running ? m_registers[DATA_ID_SPEED_TARGET] : floatBits(0.0f);
+        case DATA_ID_ELECTRICAL_ANGLE_CURRENT:
+            return floatBits(float(electrical));
+        case DATA_ID_MECHANICAL_ANGLE_CURRENT: {
+            float polePairs = qMax(1.0f, bitsFloat(m_registers[DATA_ID_POLE_PAIRS]));
+            return floatBits(float(std::fmod(360.0 * SIM_ELECTRICAL_HZ * t / polePairs, 360.0)) * (running ? 1.0f : 0.0f));
+        }
+        case DATA_ID_CONTROL_MODE:
+            return m_controlMode;
+        case DATA_ID_MOTOR_STATE:
+            return m_motorState;
+        default:
+            return m_registers[dataId];
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef SIMULATED_DEVICE_H
+#define SIMULATED_DEVICE_H
+
+#include <QIODevice>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <array>
+#include "protocol_frame.h"
+
+/**
+ * @brief 模拟电机 - 在没有硬件时代替串口，按协议应答主机命令
+ *
+ * 端口名为PORT_NAME时由SerialIoWorker代替QSerialPort打开，运行在I/O线程中。
+ * - 读/写数据、启停、校准、模式设置按协议文档应答
+ * - 状态查询返回相电流/速度/位置；状态订阅按周期主动上报
+ * - 协商到v2后，订阅上报改为攒成批量数据块、以v2变长帧发送
+ * - 突发捕获以电流环频率虚拟采样：查询状态时推进触发检测，采满后生成缓冲区供分块读取
+ * - 电流、电角度等动态量按时间生成正弦/锯齿波（浮点，小端），其余数据ID读写寄存器
+ */
+class SimulatedDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *PORT_NAME = "SIM";
+
+    explicit SimulatedDevice(QObject *parent = nullptr);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+    // 当前订阅的数据ID个数与上报周期（调试用）
+    int subscribedCount() const { return m_subCount; }
+    qint64 streamPeriodNs() const { return m_streamPeriodNs; }
+    int protocolVersion() const { return m_protocolVersion; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private slots:
+    void onStreamTick();
+
+private:
+    void handleRequest(const uint8_t *frame);
+    void handleStatusReport(const uint8_t *frame);
+    void handleNegotiate(const uint8_t *frame);
+    void reportSample();
+    void appendBlockSample(qint64 now);
+    void flushBlock();
+    void handleBurstCapture(const uint8_t *frame);
+    void updateBurstCapture();
+    void sendBurstChunk(int index);
+    int burstChunkBytes() const;
+    void reply(const ProtocolFrame &frame);
+    void scheduleReadyRead();
+    uint32_t sampleValue(uint8_t dataId) const;
+    uint32_t sampleValueAt(uint8_t dataId, qint64 ns) const;
+    float phaseCurrent(int phase, qint64 ns) const;
+
+    QByteArray m_rxPending;   // 主机写入、尚未凑满一帧的数据
+    QByteArray m_txPending;   // 待主机读取的应答与上报数据
+    bool m_readyReadQueued;
+
+    std::array<uint32_t, 256> m_registers; // 静态数据ID的寄存器值
+    uint8_t m_motorState;
+    uint8_t m_controlMode;
+
+    // 状态订阅
+    std::array<uint8_t, STATUS_REPORT_MAX_IDS> m_subIds;
+    int m_subCount;
+    qint64 m_streamPeriodNs;
+    qint64 m_nextReportNs;
+    QTimer *m_streamTimer;
+    QElapsedTimer m_clock;
+
+    // v2批量上报：样本值按样本顺序攒在m_blockValues中，凑满载荷或超过攒包时间即发出
+    int m_protocolVersion;
+    int m_maxPayload;
+    qint64 m_blockIntervalNs;
+    std::array<uint8_t, PROTOCOL_V2_MAX_PAYLOAD> m_blockValues;
+    int m_blockSamples;
+    qint64 m_blockStartNs;
+    uint8_t m_txSeq;
+
+    // 突发捕获：样本k的时刻为m_burstTriggerNs + (k - 预触发点数) × 采样间隔
+    std::array<uint8_t, BURST_CAPTURE_MAX_CHANNELS> m_burstIds;
+    int m_burstChannels;
+    qint64 m_burstPeriodNs;
+    int m_burstDepth;
+    int m_burstPreTrigger;
+    uint8_t m_burstTriggerMode;
+    uint8_t m_burstTriggerChannel;
+    float m_burstTriggerLevel;
+    uint8_t m_burstState;
+    qint64 m_burstArmNs;      // 启动时刻
+    qint64 m_burstScanNs;     // 触发检测进度：下一个待检测样本的时刻
+    qint64 m_burstTriggerNs;  // 触发时刻
+    QByteArray m_burstBuffer; // 采集完成后的数据（按样本顺序）
+};
+
+#endif // SIMULATED_DEVICE_H
@@ -0,0 +1,65 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief 单生产者/单消费者无锁队列
+ *
+ * 用于串口I/O线程向GUI线程投递解析好的协议帧：
+ * - 生产者只写 m_tail，消费者只写 m_head，两者通过 acquire/release 同步
+ * - 容量必须是2的幂，索引自然溢出后取模
+ * - head/tail 分处不同缓存行，避免伪共享
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity必须是2的幂");
+
+public:
+    SpscQueue() : m_head(0), m_tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 生产者调用：队列满时返回false
+    bool push(const T &item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用：队列空时返回false
+    bool pop(T &item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似长度（任一端调用均可，仅用于统计）
+    std::size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<std::size_t> m_head; // 读索引（消费者）
+    alignas(64) std::atomic<std::size_t> m_tail; // 写索引（生产者）
+    alignas(64) std::array<T, Capacity> m_items;
+};
+
+#endif // SPSC_QUEUE_H
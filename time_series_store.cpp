@@ -0,0 +1,263 @@
+#include "time_series_store.h"
+#include <QtGlobal>
+#include <algorithm>
+
+TimeSeriesStore::TimeSeriesStore(int maxSamples, qint64 maxAgeNs)
+    : m_maxSamples(qMax(1, maxSamples))
+    , m_maxAgeNs(maxAgeNs)
+{
+}
+
+int TimeSeriesStore::channel(const QString &name)
+{
+    int ch = m_channelIndex.value(name, -1);
+    if (ch < 0) {
+        ch = m_channels.size();
+        Channel c;
+        c.name = name;
+        m_channels.append(c);
+        m_channelIndex.insert(name, ch);
+    }
+    return ch;
+}
+
+void TimeSeriesStore::append(int ch, qint64 timeNs, double value)
+{
+    Channel &c = m_channels[ch];
+
+    // 通道内时间不减，保证按时间二分查找
+    if (c.end > c.begin) {
+        timeNs = qMax(timeNs, c.times[slot(c.end - 1)]);
+    }
+
+    if (c.end < m_maxSamples) {
+        // 未写满一圈：两列按需增长
+        c.times.append(timeNs);
+        c.values.append(value);
+        if (c.times.size() == m_maxSamples) {
+            // 写满一圈后不再增长，释放按倍数增长多留的容量，占用与上限一致
+            c.times.squeeze();
+            c.values.squeeze();
+        }
+    } else {
+        int i = slot(c.end);
+        if (c.end - m_maxSamples >= c.begin) {
+            c.droppedUntilNs = c.times[i]; // 覆盖的是仍有效的最旧样本
+        }
+        c.times[i] = timeNs;
+        c.values[i] = value;
+    }
+    ++c.end;
+    trim(c);
+
+    Bucket sample;
+    sample.firstNs = sample.lastNs = timeNs;
+    sample.min = sample.max = sample.mean = value;
+    accumulate(c, 0, sample, 1);
+}
+
+void TimeSeriesStore::accumulate(Channel &c, int level, const Bucket &item, qint64 samples)
+{
+    Level &l = c.levels[level];
+    if (l.pendingItems == 0) {
+        l.pending = item;
+        l.pendingSum = 0.0;
+        l.pendingSamples = 0;
+    } else {
+        l.pending.lastNs = item.lastNs;
+        l.pending.min = qMin(l.pending.min, item.min);
+        l.pending.max = qMax(l.pending.max, item.max);
+    }
+    l.pendingSum += item.mean * samples;
+    l.pendingSamples += samples;
+    if (++l.pendingItems < PYRAMID_FANOUT) {
+        return;
+    }
+
+    // 本级桶完成：存入环，再作为一个元素并入上一级
+    Bucket done = l.pending;
+    done.mean = l.pendingSum / l.pendingSamples;
+    if (l.end < PYRAMID_LEVEL_CAPACITY) {
+        l.buckets.append(done);
+        if (l.buckets.size() == PYRAMID_LEVEL_CAPACITY) {
+            l.buckets.squeeze();
+        }
+    } else {
+        Bucket &slotBucket = l.buckets[int(l.end % PYRAMID_LEVEL_CAPACITY)];
+        if (l.end - PYRAMID_LEVEL_CAPACITY >= l.begin) {
+            l.droppedUntilNs = slotBucket.lastNs; // 覆盖的是仍有效的最旧桶
+        }
+        slotBucket = done;
+    }
+    ++l.end;
+    l.begin = qMax(l.begin, l.end - PYRAMID_LEVEL_CAPACITY);
+    l.pendingItems = 0;
+
+    if (level + 1 < PYRAMID_LEVELS) {
+        accumulate(c, level + 1, done, l.pendingSamples);
+    }
+}
+
+qint64 TimeSeriesStore::bucketLowerBound(int ch, int level, qint64 timeNs) const
+{
+    const Level &l = m_channels[ch].levels[level];
+    qint64 lo = l.begin;
+    qint64 hi = l.end;
+    while (lo < hi) {
+        qint64 mid = lo + (hi - lo) / 2;
+        if (l.buckets[int(mid % PYRAMID_LEVEL_CAPACITY)].firstNs < timeNs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int TimeSeriesStore::readBuckets(int ch, int level, qint64 fromSeq, qint64 toSeq, Bucket *out) const
+{
+    const Level &l = m_channels[ch].levels[level];
+    fromSeq = qMax(fromSeq, l.begin);
+    toSeq = qMin(toSeq, l.end);
+    if (fromSeq >= toSeq) {
+        return 0;
+    }
+    int count = int(toSeq - fromSeq);
+    int first = int(fromSeq % PYRAMID_LEVEL_CAPACITY);
+    int firstLen = qMin(count, PYRAMID_LEVEL_CAPACITY - first);
+    std::copy(l.buckets.constData() + first, l.buckets.constData() + first + firstLen, out);
+    std::copy(l.buckets.constData(), l.buckets.constData() + (count - firstLen), out + firstLen);
+    return count;
+}
+
+void TimeSeriesStore::trim(Channel &c) const
+{
+    // 样本数上限：最旧的样本已被覆盖
+    if (c.end - c.begin > m_maxSamples) {
+        c.begin = c.end - m_maxSamples;
+    }
+
+    // 时间跨度：相对最新样本过旧的样本失效
+    if (m_maxAgeNs > 0 && c.end > c.begin) {
+        qint64 oldest = c.times[slot(c.end - 1)] - m_maxAgeNs;
+        while (c.begin < c.end && c.times[slot(c.begin)] < oldest) {
+            c.droppedUntilNs = c.times[slot(c.begin)];
+            ++c.begin;
+        }
+    }
+}
+
+qint64 TimeSeriesStore::lowerBound(int ch, qint64 timeNs) const
+{
+    const Channel &c = m_channels[ch];
+    qint64 lo = c.begin;
+    qint64 hi = c.end;
+    while (lo < hi) {
+        qint64 mid = lo + (hi - lo) / 2;
+        if (c.times[slot(mid)] < timeNs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int TimeSeriesStore::read(int ch, qint64 fromSeq, qint64 toSeq, qint64 *times, double *values) const
+{
+    const Channel &c = m_channels[ch];
+    fromSeq = qMax(fromSeq, c.begin);
+    toSeq = qMin(toSeq, c.end);
+    if (fromSeq >= toSeq) {
+        return 0;
+    }
+
+    // 序号范围在环上最多分成两段，各段按列整块复制
+    int count = int(toSeq - fromSeq);
+    int first = slot(fromSeq);
+    int firstLen = qMin(count, m_maxSamples - first);
+    if (times) {
+        std::copy(c.times.constData() + first, c.times.constData() + first + firstLen, times);
+        std::copy(c.times.constData(), c.times.constData() + (count - firstLen), times + firstLen);
+    }
+    if (values) {
+        std::copy(c.values.constData() + first, c.values.constData() + first + firstLen, values);
+        std::copy(c.values.constData(), c.values.constData() + (count - firstLen), values + firstLen);
+    }
+    return count;
+}
+
+void TimeSeriesStore::setRetention(int maxSamples, qint64 maxAgeNs)
+{
+    maxSamples = qMax(1, maxSamples);
+    if (maxSamples != m_maxSamples) {
+        // 容量变化时按新的取模位置重新排列仍保留的样本
+        for (int ch = 0; ch < m_channels.size(); ++ch) {
+            Channel &c = m_channels[ch];
+            qint64 begin = qMax(c.begin, c.end - maxSamples);
+            if (begin > c.begin) {
+                c.droppedUntilNs = c.times[slot(begin - 1)];
+            }
+            int count = int(c.end - begin);
+            QVector<qint64> times(count);
+            QVector<double> values(count);
+            read(ch, begin, c.end, times.data(), values.data());
+
+            int size = int(qMin<qint64>(c.end, maxSamples));
+            c.times.resize(size);
+            c.values.resize(size);
+            c.times.squeeze();
+            c.values.squeeze();
+            for (int k = 0; k < count; ++k) {
+                int i = int((begin + k) % maxSamples);
+                c.times[i] = times[k];
+                c.values[i] = values[k];
+            }
+            c.begin = begin;
+        }
+        m_maxSamples = maxSamples;
+    }
+
+    m_maxAgeNs = maxAgeNs;
+    for (Channel &c : m_channels) {
+        trim(c);
+    }
+}
+
+void TimeSeriesStore::clear()
+{
+    for (Channel &c : m_channels) {
+        c.begin = c.end;
+        c.droppedUntilNs = std::numeric_limits<qint64>::min();
+        for (Level &l : c.levels) {
+            l.begin = l.end;
+            l.droppedUntilNs = std::numeric_limits<qint64>::min();
+            l.pendingItems = 0;
+        }
+    }
+}
+
+qint64 TimeSeriesStore::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (int ch = 0; ch < m_channels.size(); ++ch) {
+        bytes += channelMemoryBytes(ch);
+    }
+    return bytes;
+}
+
+qint64 TimeSeriesStore::channelMemoryBytes(int ch) const
+{
+    const Channel &c = m_channels[ch];
+    qint64 bytes = qint64(c.times.capacity()) * sizeof(qint64) + qint64(c.values.capacity()) * sizeof(double);
+    for (const Level &l : c.levels) {
+        bytes += qint64(l.buckets.capacity()) * sizeof(Bucket);
+    }
+    return bytes;
+}
+
+qint64 TimeSeriesStore::channelMemoryLimit() const
+{
+    return qint64(m_maxSamples) * (sizeof(qint64) + sizeof(double))
+           + qint64(PYRAMID_LEVELS) * PYRAMID_LEVEL_CAPACITY * sizeof(Bucket);
+}
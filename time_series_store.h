@@ -0,0 +1,130 @@
+#ifndef TIME_SERIES_STORE_H
+#define TIME_SERIES_STORE_H
+
+#include <QVector>
+#include <QString>
+#include <QHash>
+#include <limits>
+
+/**
+ * @brief 按通道分列存放的时间序列环形存储
+ *
+ * 每个通道的时间戳与数值分两列连续存放，收到的每个样本都写入，不做抽样。
+ * 样本按通道内累计序号编址（从0开始，不回绕），读取方记住上次读到的序号，
+ * 下次从该序号继续读，任何速率下都不会漏读或重复；按时间查询时二分查找。
+ * 保留策略：超过样本数上限时覆盖最旧的样本，早于最新样本maxAge的样本同时失效。
+ *
+ * 长时间记录另有逐级汇总的金字塔：第0级每16个样本汇成一个桶（最小、最大、均值），
+ * 第k级每16个第k-1级的桶汇成一个桶，写入样本时增量更新。每级是固定容量的环，
+ * 原始样本过期后仍可从各级读到更早的概貌，缩小到小时级时读粗级别，点数与像素数相当。
+ * 每通道内存上限见channelMemoryLimit()。
+ * - 非线程安全，只在GUI线程使用
+ * - 时间戳为单调时钟纳秒，通道内按写入顺序保持不减（乱序的样本按上一样本时刻记）
+ */
+class TimeSeriesStore
+{
+public:
+    static constexpr int DEFAULT_MAX_SAMPLES = 200000;               // 每通道样本数上限
+    static constexpr qint64 DEFAULT_MAX_AGE_NS = 60LL * 1000000000LL; // 保留最近60秒
+
+    // 汇总金字塔：每级扇出、级数、每级桶数上限
+    // 10kHz时各级依次覆盖约13秒、3.5分钟、56分钟、15小时、10天
+    static constexpr int PYRAMID_FANOUT = 16;
+    static constexpr int PYRAMID_LEVELS = 5;
+    static constexpr int PYRAMID_LEVEL_CAPACITY = 8192;
+
+    // 汇总桶：覆盖的首末样本时刻与数值统计
+    struct Bucket {
+        qint64 firstNs = 0;
+        qint64 lastNs = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+    };
+
+    explicit TimeSeriesStore(int maxSamples = DEFAULT_MAX_SAMPLES, qint64 maxAgeNs = DEFAULT_MAX_AGE_NS);
+
+    // 取通道号，通道不存在时创建
+    int channel(const QString &name);
+    // 查找通道号，不存在返回-1
+    int findChannel(const QString &name) const { return m_channelIndex.value(name, -1); }
+    int channelCount() const { return m_channels.size(); }
+    QString channelName(int ch) const { return m_channels[ch].name; }
+
+    // 写入一个样本
+    void append(int ch, qint64 timeNs, double value);
+
+    // 仍保留的样本序号范围[beginSeq, endSeq)
+    qint64 beginSeq(int ch) const { return m_channels[ch].begin; }
+    qint64 endSeq(int ch) const { return m_channels[ch].end; }
+    qint64 timeAt(int ch, qint64 seq) const { return m_channels[ch].times[slot(seq)]; }
+    // 最新一个被覆盖或过期丢弃的样本的时刻，清空后还没有丢弃过样本时为qint64最小值；
+    // 早于该时刻（含）的样本可能已不全，晚于它的样本都还在
+    qint64 droppedUntilNs(int ch) const { return m_channels[ch].droppedUntilNs; }
+    double valueAt(int ch, qint64 seq) const { return m_channels[ch].values[slot(seq)]; }
+
+    // 第一个时间戳不早于timeNs的样本序号（都更早时返回endSeq）
+    qint64 lowerBound(int ch, qint64 timeNs) const;
+
+    // 复制序号[fromSeq, toSeq)的样本（越出保留范围的部分截掉），返回复制的个数
+    int read(int ch, qint64 fromSeq, qint64 toSeq, qint64 *times, double *values) const;
+
+    // 汇总金字塔：第level级（0为1:16）仍保留的桶序号范围、按首样本时刻查找、整块复制
+    qint64 bucketBeginSeq(int ch, int level) const { return m_channels[ch].levels[level].begin; }
+    qint64 bucketEndSeq(int ch, int level) const { return m_channels[ch].levels[level].end; }
+    const Bucket &bucketAt(int ch, int level, qint64 seq) const
+    { return m_channels[ch].levels[level].buckets[int(seq % PYRAMID_LEVEL_CAPACITY)]; }
+    qint64 bucketDroppedUntilNs(int ch, int level) const { return m_channels[ch].levels[level].droppedUntilNs; }
+    qint64 bucketLowerBound(int ch, int level, qint64 timeNs) const;
+    int readBuckets(int ch, int level, qint64 fromSeq, qint64 toSeq, Bucket *out) const;
+
+    // 保留策略：样本数上限与时间跨度（纳秒）；缩小时只保留最新的样本（只作用于原始样本，各级汇总容量固定）
+    void setRetention(int maxSamples, qint64 maxAgeNs);
+    int maxSamples() const { return m_maxSamples; }
+    qint64 maxAgeNs() const { return m_maxAgeNs; }
+
+    // 清空所有通道的样本（通道号与序号保持，读取方的序号依然有效）
+    void clear();
+
+    // 所有通道/单个通道当前占用的字节数（原始样本两列加各级汇总）
+    qint64 memoryBytes() const;
+    qint64 channelMemoryBytes(int ch) const;
+    // 按当前保留策略，每个通道最多占用的字节数
+    qint64 channelMemoryLimit() const;
+
+private:
+    // 一级汇总：已完成的桶按序号取模存放，pending为正在汇总的桶
+    struct Level {
+        QVector<Bucket> buckets;
+        qint64 begin = 0;
+        qint64 end = 0;
+        qint64 droppedUntilNs = std::numeric_limits<qint64>::min(); // 最新被覆盖的桶的末样本时刻
+        Bucket pending;
+        double pendingSum = 0.0; // 下级均值按样本数加权累加
+        qint64 pendingSamples = 0;
+        int pendingItems = 0;    // 已并入的下级元素个数，满PYRAMID_FANOUT即完成
+    };
+
+    struct Channel {
+        QString name;
+        QVector<qint64> times;  // 时间戳列
+        QVector<double> values; // 数值列
+        qint64 begin = 0;       // 最旧的有效样本序号
+        qint64 end = 0;         // 下一个写入的序号
+        qint64 droppedUntilNs = std::numeric_limits<qint64>::min(); // 最新被丢弃的样本时刻（清空不算丢弃）
+        Level levels[PYRAMID_LEVELS];
+    };
+
+    // 两列先按需增长到上限，此后按序号取模覆盖
+    int slot(qint64 seq) const { return int(seq % m_maxSamples); }
+    void trim(Channel &c) const;
+    // 把一个下级元素（样本或桶，samples为其代表的样本数）并入第level级
+    void accumulate(Channel &c, int level, const Bucket &item, qint64 samples);
+
+    QVector<Channel> m_channels;
+    QHash<QString, int> m_channelIndex;
+    int m_maxSamples;
+    qint64 m_maxAgeNs;
+};
+
+#endif // TIME_SERIES_STORE_H
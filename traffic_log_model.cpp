@@ -0,0 +1,292 @@
+#include "traffic_log_model.h"
+#include "serial_io_worker.h" // monotonicNowNs
+#include <QDateTime>
+#include <cstring>
+
+namespace {
+
+// 每个字节对应的两位大写十六进制字符（UTF-16），格式化时按字节查表整对写入
+struct HexTable {
+    char16_t pairs[256][2];
+    HexTable()
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        for (int b = 0; b < 256; ++b) {
+            pairs[b][0] = char16_t(digits[b >> 4]);
+            pairs[b][1] = char16_t(digits[b & 0x0F]);
+        }
+    }
+};
+
+const HexTable &hexTable()
+{
+    static const HexTable table;
+    return table;
+}
+
+} // namespace
+
+TrafficLogModel::TrafficLogModel(int capacity, int arenaBytes, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_capacity(qMax(1, capacity))
+    , m_begin(0)
+    , m_end(0)
+    , m_count(0)
+    , m_arenaBytes(1)
+    , m_arenaEnd(0)
+    , m_arenaUsed(0)
+    , m_flushTimer(new QTimer(this))
+    , m_hexDisplay(true)
+    , m_wallOriginMs(QDateTime::currentMSecsSinceEpoch())
+    , m_monoOriginNs(monotonicNowNs())
+{
+    // 字节环取不小于arenaBytes的2的幂（上限1GB），位置取模只需按位与
+    while (m_arenaBytes < quint32(qBound(1, arenaBytes, 1 << 30))) {
+        m_arenaBytes <<= 1;
+    }
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &TrafficLogModel::flush);
+}
+
+int TrafficLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant TrafficLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const Record &record = recordAt(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        if (m_hexDisplay) {
+            // HEX直接接在行首之后写入，不再为数据部分单独生成字符串
+            QString line = QString("%1 %2: ").arg(timestampText(record.ns),
+                                                  isTx(record) ? QString("[发送] ") : QString("[接收] "));
+            appendHex(line, bytesAt(record));
+            return line;
+        }
+        return QString("%1 %2: %3")
+            .arg(timestampText(record.ns),
+                 isTx(record) ? QString("[发送] ") : QString("[接收] "),
+                 formatBytes(bytesAt(record), false));
+    case TimestampRole:
+        return timestampText(record.ns);
+    case IsTxRole:
+        return isTx(record);
+    case TextRole:
+        return formatBytes(bytesAt(record), m_hexDisplay);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TrafficLogModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[Qt::DisplayRole] = "display";
+    roles[TimestampRole] = "timestamp";
+    roles[IsTxRole] = "isTx";
+    roles[TextRole] = "text";
+    return roles;
+}
+
+qint64 TrafficLogModel::memoryBytes() const
+{
+    return qint64(m_records.capacity() + m_pending.capacity()) * qint64(sizeof(Record))
+           + m_arena.capacity() + m_pendingBytes.capacity();
+}
+
+QByteArray TrafficLogModel::bytesAt(const Record &r) const
+{
+    int len = length(r);
+    quint32 first = r.pos & (m_arenaBytes - 1);
+    if (first + quint32(len) <= quint32(m_arena.size())) {
+        // 不跨环尾：直接引用环内数据，调用方格式化完即释放
+        return QByteArray::fromRawData(m_arena.constData() + first, len);
+    }
+    int firstLen = int(m_arenaBytes - first);
+    QByteArray out(len, Qt::Uninitialized);
+    memcpy(out.data(), m_arena.constData() + first, size_t(firstLen));
+    memcpy(out.data() + firstLen, m_arena.constData(), size_t(len - firstLen));
+    return out;
+}
+
+QString TrafficLogModel::timestampText(qint64 ns) const
+{
+    qint64 msecs = m_wallOriginMs + (ns - m_monoOriginNs) / 1000000;
+    return QDateTime::fromMSecsSinceEpoch(msecs).toString("hh:mm:ss.zzz");
+}
+
+void TrafficLogModel::append(const QByteArray &data, bool isTx, qint64 timestampNs)
+{
+    // 单条超过字节环大小时只保留开头部分
+    int len = int(qMin<qint64>(data.size(), m_arenaBytes));
+
+    Record record;
+    record.ns = timestampNs > 0 ? timestampNs : monotonicNowNs();
+    record.pos = quint32(m_pendingBytes.size());
+    record.lengthAndDir = quint32(len) | (isTx ? TX_FLAG : 0u);
+    m_pending.append(record);
+    m_pendingBytes.append(data.constData(), len);
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void TrafficLogModel::evictOldest(int records)
+{
+    beginRemoveRows(QModelIndex(), 0, records - 1);
+    for (int i = 0; i < records; ++i) {
+        m_arenaUsed -= length(recordAt(i));
+    }
+    m_begin += records;
+    m_count -= records;
+    endRemoveRows();
+}
+
+void TrafficLogModel::flush()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    // 一帧内超过容量的部分插入后也会被淘汰，只取最新的若干条（记录数与字节数都不超限）
+    int skip = int(m_pending.size());
+    qint64 incomingBytes = 0;
+    while (skip > 0 && int(m_pending.size()) - skip < m_capacity) {
+        int len = length(m_pending[skip - 1]);
+        if (incomingBytes + len > m_arenaBytes) {
+            break;
+        }
+        incomingBytes += len;
+        --skip;
+    }
+    int incoming = int(m_pending.size()) - skip;
+
+    // 先一次性淘汰最旧的记录，给新记录腾出位置（本帧已丢弃部分新记录时，更早的记录全部淘汰）
+    int evict = skip > 0 ? m_count : qMax(0, m_count + incoming - m_capacity);
+    qint64 freed = 0;
+    for (int i = 0; i < evict; ++i) {
+        freed += length(recordAt(i));
+    }
+    while (evict < m_count && m_arenaUsed - freed + incomingBytes > m_arenaBytes) {
+        freed += length(recordAt(evict++));
+    }
+    if (evict > 0) {
+        evictOldest(evict);
+    }
+
+    // 字节环未写满一圈前按需增长（位置尚未取模回绕，增长不影响已有数据）
+    if (quint32(m_arena.size()) < m_arenaBytes && m_arenaEnd + quint64(incomingBytes) > quint64(m_arena.size())) {
+        qint64 want = qMax<qint64>(qint64(m_arena.size()) * 2, qint64(m_arenaEnd) + incomingBytes);
+        m_arena.resize(int(qMin<qint64>(want, m_arenaBytes)));
+        if (quint32(m_arena.size()) == m_arenaBytes) {
+            m_arena.squeeze();
+        }
+    }
+
+    // 再一次性插入本帧的全部新记录：数据拷入字节环，索引写入记录环
+    beginInsertRows(QModelIndex(), m_count, m_count + incoming - 1);
+    for (int i = skip; i < m_pending.size(); ++i) {
+        Record record = m_pending[i];
+        int len = length(record);
+        const char *src = m_pendingBytes.constData() + record.pos;
+        quint32 first = m_arenaEnd & (m_arenaBytes - 1);
+        int firstLen = int(qMin<quint32>(quint32(len), m_arenaBytes - first));
+        memcpy(m_arena.data() + first, src, size_t(firstLen));
+        memcpy(m_arena.data(), src + firstLen, size_t(len - firstLen));
+        record.pos = m_arenaEnd;
+        m_arenaEnd += quint32(len);
+        m_arenaUsed += len;
+
+        if (m_end < m_capacity) {
+            m_records.append(record);
+            if (m_records.size() == m_capacity) {
+                m_records.squeeze();
+            }
+        } else {
+            m_records[int(m_end % m_capacity)] = record;
+        }
+        ++m_end;
+    }
+    m_count += incoming;
+    endInsertRows();
+
+    m_pending.clear();
+    m_pendingBytes.clear();
+    emit countChanged();
+}
+
+void TrafficLogModel::clear()
+{
+    m_flushTimer->stop();
+    m_pending.clear();
+    m_pendingBytes.clear();
+    if (m_count == 0) {
+        return;
+    }
+    beginResetModel();
+    // 释放记录环与字节环，下次写入从头按需增长
+    m_records = QVector<Record>();
+    m_arena = QByteArray();
+    m_begin = 0;
+    m_end = 0;
+    m_count = 0;
+    m_arenaEnd = 0;
+    m_arenaUsed = 0;
+    endResetModel();
+    emit countChanged();
+}
+
+void TrafficLogModel::setHexDisplay(bool hex)
+{
+    if (m_hexDisplay == hex) {
+        return;
+    }
+    m_hexDisplay = hex;
+    if (m_count > 0) {
+        // 只通知变化，实际格式化在视图为可见行取数时进行
+        emit dataChanged(index(0), index(m_count - 1), { Qt::DisplayRole, TextRole });
+    }
+}
+
+void TrafficLogModel::appendHex(QString &out, const QByteArray &data)
+{
+    int n = int(data.size());
+    if (n == 0) {
+        return;
+    }
+    // 一次扩到最终长度，再直接写UTF-16缓冲区：每字节一次查表，没有临时字符串
+    int start = int(out.size());
+    out.resize(start + n * 3 - 1);
+    char16_t *dst = reinterpret_cast<char16_t *>(out.data()) + start;
+    const unsigned char *src = reinterpret_cast<const unsigned char *>(data.constData());
+    const HexTable &table = hexTable();
+    for (int i = 0; i < n - 1; ++i) {
+        memcpy(dst, table.pairs[src[i]], sizeof(table.pairs[0]));
+        dst[2] = u' ';
+        dst += 3;
+    }
+    memcpy(dst, table.pairs[src[n - 1]], sizeof(table.pairs[0]));
+}
+
+QString TrafficLogModel::formatBytes(const QByteArray &data, bool hex)
+{
+    QString result;
+    if (hex) {
+        appendHex(result, data);
+        return result;
+    }
+    result = QString::fromLatin1(data);
+    // 处理非打印字符
+    result.replace('\r', "\\r");
+    result.replace('\n', "\\n");
+    result.replace('\t', "\\t");
+    return result;
+}
@@ -0,0 +1,114 @@
+#ifndef TRAFFIC_LOG_MODEL_H
+#define TRAFFIC_LOG_MODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QVector>
+#include <QTimer>
+
+/**
+ * @brief 串口收发记录的列表模型，对应SerialCommunicationModule中的ListView
+ *
+ * 记录以紧凑的二进制形式保存，追加与淘汰都是O(1)，不再每次收发都重新拼接整段文本。
+ * - 原始字节连续写入定长字节环（arena），每条记录只占16字节索引：单调时钟时刻、环内位置、长度与方向
+ * - 收发数据先暂存，每个显示帧（约16ms）统一插入一次，并一次性淘汰超出容量的最旧记录
+ *   （记录数或字节数任一超限即淘汰）
+ * - 时刻与文本都在视图取数时按当前显示方式（HEX/文本）格式化，
+ *   ListView只为可见行取数，格式化量与可见行数相当
+ */
+class TrafficLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    // 当前条数
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        TimestampRole = Qt::UserRole + 1, // "hh:mm:ss.zzz"
+        IsTxRole,                         // true为发送
+        TextRole                          // 格式化后的数据
+    };
+
+    static constexpr int DEFAULT_CAPACITY = 1 << 20;    // 最多保留的记录数（约100万帧）
+    static constexpr int DEFAULT_ARENA_BYTES = 1 << 24; // 原始字节环大小（16MB，取2的幂）
+    static constexpr int FLUSH_INTERVAL_MS = 16;        // 暂存记录插入模型的间隔（约一个显示帧）
+
+    explicit TrafficLogModel(int capacity = DEFAULT_CAPACITY, int arenaBytes = DEFAULT_ARENA_BYTES,
+                             QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_count; }
+    int capacity() const { return m_capacity; }
+
+    // 当前占用的内存（记录索引与字节环的已分配容量）
+    qint64 memoryBytes() const;
+
+    /**
+     * @brief 追加一条收发记录（下一显示帧插入）
+     * @param data 原始字节
+     * @param isTx true为发送
+     * @param timestampNs 收发时刻（单调时钟纳秒，0表示取当前时刻）
+     */
+    void append(const QByteArray &data, bool isTx, qint64 timestampNs = 0);
+
+    // 清空全部记录（包括尚未插入的）
+    void clear();
+
+    // 切换显示方式，已有记录按新方式重新显示
+    void setHexDisplay(bool hex);
+
+    // 按显示方式格式化数据：HEX为空格分隔的大写十六进制，文本模式转义\r\n\t
+    static QString formatBytes(const QByteArray &data, bool hex);
+
+    // 把数据按HEX格式（空格分隔的大写十六进制）追加到out末尾，查表直接写入
+    static void appendHex(QString &out, const QByteArray &data);
+
+signals:
+    void countChanged();
+
+private slots:
+    void flush();
+
+private:
+    // 一条记录的索引（16字节），数据在字节环中
+    struct Record {
+        qint64 ns = 0;            // 收发时刻（单调时钟纳秒）
+        quint32 pos = 0;          // 数据在字节环中的起始位置（按环大小取模前的值，模2^32）
+        quint32 lengthAndDir = 0; // 低31位为长度，最高位为发送标志
+    };
+    static constexpr quint32 TX_FLAG = 0x80000000u;
+
+    static int length(const Record &r) { return int(r.lengthAndDir & ~TX_FLAG); }
+    static bool isTx(const Record &r) { return (r.lengthAndDir & TX_FLAG) != 0; }
+
+    const Record &recordAt(int row) const { return m_records[int((m_begin + row) % m_capacity)]; }
+    QByteArray bytesAt(const Record &r) const; // 取出记录的数据（不跨环尾时不复制）
+    QString timestampText(qint64 ns) const;
+    void evictOldest(int records);
+
+    int m_capacity;               // 记录数上限
+    QVector<Record> m_records;    // 记录环，按序号取模定位；未写满一圈前按需增长
+    qint64 m_begin;               // 第0行的序号
+    qint64 m_end;                 // 下一条记录的序号
+    int m_count;
+
+    QByteArray m_arena;           // 原始字节环，未写满一圈前按需增长到m_arenaBytes
+    quint32 m_arenaBytes;         // 字节环大小（2的幂）
+    quint32 m_arenaEnd;           // 下一条数据的写入位置（模2^32）
+    qint64 m_arenaUsed;           // 未淘汰记录的数据总字节数
+
+    QVector<Record> m_pending;    // 等待插入的记录，pos为m_pendingBytes中的偏移
+    QByteArray m_pendingBytes;
+    QTimer *m_flushTimer;
+    bool m_hexDisplay;
+
+    // 单调时钟到本地时间的换算（构造时取一次）
+    qint64 m_wallOriginMs;
+    qint64 m_monoOriginNs;
+};
+
+#endif // TRAFFIC_LOG_MODEL_H